@@ -0,0 +1,102 @@
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+#include "coro/coro.hpp"
+
+using namespace coro;
+
+// wrk-style load generator, every connection keeps depth pipelined requests in flight
+// usage: http_load_bench <port> <connections> <depth> <seconds>
+
+static constexpr std::string_view kRequest = "GET / HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+
+std::atomic<uint64_t> g_responses{0};
+std::atomic<uint64_t> g_errors{0};
+
+task<> worker(int port, int depth, std::chrono::steady_clock::time_point deadline)
+{
+    auto client = net::tcp_client("127.0.0.1", port);
+    int  fd     = co_await client.connect();
+    if (fd < 0)
+    {
+        g_errors++;
+        co_return;
+    }
+
+    auto     stream = net::buffered_stream(net::tcp_connector(fd));
+    uint64_t done   = 0;
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        for (int i = 0; i < depth; i++)
+        {
+            co_await stream.write(kRequest);
+        }
+        if (co_await stream.flush() < 0)
+        {
+            g_errors++;
+            break;
+        }
+
+        int i = 0;
+        for (; i < depth; i++)
+        {
+            auto head = co_await stream.read_until("\r\n\r\n");
+            auto pos  = head.find("Content-Length: ");
+            if (head.empty() || pos == std::string_view::npos)
+            {
+                break;
+            }
+            size_t len = 0;
+            std::from_chars(head.data() + pos + 16, head.data() + head.size(), len);
+            if (len > 0 && (co_await stream.read_exact(len)).size() != len)
+            {
+                break;
+            }
+        }
+        done += i;
+        if (i != depth)
+        {
+            g_errors++;
+            break;
+        }
+    }
+
+    g_responses += done;
+    co_await stream.connector().close();
+}
+
+int main(int argc, char const* argv[])
+{
+    if (argc != 5)
+    {
+        printf("Usage: %s <port> <connections> <depth> <seconds>\n", argv[0]);
+        return 1;
+    }
+    int port    = atoi(argv[1]);
+    int conns   = atoi(argv[2]);
+    int depth   = atoi(argv[3]);
+    int seconds = atoi(argv[4]);
+
+    scheduler::init();
+
+    auto start    = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::seconds(seconds);
+    for (int i = 0; i < conns; i++)
+    {
+        submit_to_scheduler(worker(port, depth, deadline));
+    }
+    scheduler::loop();
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf(
+        "%lu responses in %.2fs, %.0f req/s, %lu errors\n",
+        g_responses.load(),
+        elapsed,
+        g_responses.load() / elapsed,
+        g_errors.load());
+    return 0;
+}
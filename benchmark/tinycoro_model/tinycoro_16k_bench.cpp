@@ -27,11 +27,14 @@ task<> server(int port)
 {
     auto server = net::tcp_server(port);
     log::info("server start in {}", port);
-    int client_fd;
-    while ((client_fd = co_await server.accept()) > 0)
+    auto stream = server.accept_stream();
+    int  client_fd;
+    while ((client_fd = co_await stream.next()) > 0)
     {
         submit_to_scheduler(session(client_fd));
     }
+    // the loop also stops at a transient error, where multishot accept is still running
+    co_await stream.cancel();
 }
 
 int main(int argc, char const* argv[])
@@ -23,15 +23,19 @@ task<> session(int fd)
     assert(ret == 0);
 }
 
+// every context runs its own listener, sessions stay on the context accepting them
 task<> server(int port)
 {
-    auto server = net::tcp_server(port);
+    auto server = net::tcp_server(nullptr, port, net::listen_options{.reuse_port = true});
     log::info("server start in {}", port);
-    int client_fd;
-    while ((client_fd = co_await server.accept()) > 0)
+    auto stream = server.accept_stream();
+    int  client_fd;
+    while ((client_fd = co_await stream.next()) > 0)
     {
-        submit_to_scheduler(session(client_fd));
+        submit_to_context(session(client_fd));
     }
+    // the loop also stops at a transient error, where multishot accept is still running
+    co_await stream.cancel();
 }
 
 int main(int argc, char const* argv[])
@@ -39,7 +43,7 @@ int main(int argc, char const* argv[])
     /* code */
     scheduler::init();
 
-    submit_to_scheduler(server(8000));
+    scheduler::submit_to_each([] { return server(8000); });
     scheduler::loop();
     return 0;
 }
@@ -0,0 +1,19 @@
+#include "coro/coro.hpp"
+
+using namespace coro;
+
+int main(int argc, char const* argv[])
+{
+    scheduler::init();
+
+    http::server srv(
+        [](const http::request& req, http::response& resp)
+        {
+            resp.header("Content-Type", "text/plain");
+            resp.body("Hello, World!");
+        });
+    // every context runs its own listener, so requests are served without crossing contexts
+    scheduler::submit_to_each([&srv] { return srv.serve(nullptr, 8000, net::listen_options{.reuse_port = true}); });
+    scheduler::loop();
+    return 0;
+}
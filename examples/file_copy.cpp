@@ -0,0 +1,81 @@
+#include <cstring>
+
+#include "coro/coro.hpp"
+
+using namespace coro;
+
+#define BUFFLEN 65536
+
+task<> copy(const char* src, const char* dst)
+{
+    int in = co_await fs::open(src, O_RDONLY | O_DIRECT);
+    if (in < 0)
+    {
+        // file system may not support O_DIRECT
+        in = co_await fs::open(src, O_RDONLY);
+    }
+    int out = co_await fs::open(dst, O_WRONLY | O_CREAT | O_TRUNC);
+    if (in < 0 || out < 0)
+    {
+        log::error("open file failed");
+        co_return;
+    }
+
+    auto src_file = fs::file(in);
+    auto dst_file = fs::file(out);
+    auto buf      = fs::aligned_buffer(BUFFLEN);
+
+    struct statx st;
+    if (auto ret = co_await src_file.stat(&st); ret < 0)
+    {
+        log::error("stat {} failed: {}", src, strerror(-ret));
+        co_await src_file.close();
+        co_await dst_file.close();
+        co_return;
+    }
+    // preallocation only saves extent allocation, file system may not support it
+    if (st.stx_size > 0)
+    {
+        if (auto ret = co_await dst_file.fallocate(0, st.stx_size); ret < 0)
+        {
+            log::warn("fallocate {} failed: {}", dst, strerror(-ret));
+        }
+    }
+
+    uint64_t offset = 0;
+    int      ret    = 0;
+    while ((ret = co_await src_file.read(buf, offset)) > 0)
+    {
+        if (auto wret = co_await dst_file.write(buf.data(), ret, offset); wret != ret)
+        {
+            log::error("write {} failed: {}", dst, wret < 0 ? strerror(-wret) : "short write");
+            break;
+        }
+        offset += ret;
+    }
+    if (ret < 0)
+    {
+        log::error("read {} failed: {}", src, strerror(-ret));
+    }
+
+    co_await dst_file.fsync();
+    co_await src_file.close();
+    co_await dst_file.close();
+    log::info("copy {} bytes from {} to {}", offset, src, dst);
+}
+
+int main(int argc, char const* argv[])
+{
+    /* code */
+    if (argc < 3)
+    {
+        log::error("usage: file_copy <src> <dst>");
+        return 0;
+    }
+
+    scheduler::init();
+
+    submit_to_scheduler(copy(argv[1], argv[2]));
+    scheduler::loop();
+    return 0;
+}
@@ -24,10 +24,13 @@ int main(int argc, char const* argv[])
     /* code */
     scheduler::init();
 
+    // submit all tasks at once, each context is woken up only once
+    std::vector<task<>> tasks;
     for (int i = 0; i < TASK_NUM; i++)
     {
-        submit_to_scheduler(calc(i, i * 3, (i + 1) * 3, vec));
+        tasks.push_back(calc(i, i * 3, (i + 1) * 3, vec));
     }
+    scheduler::submit_batch(tasks);
 
     scheduler::loop();
     return 0;
@@ -0,0 +1,116 @@
+#include <string>
+#include <unordered_map>
+
+#include "coro/coro.hpp"
+
+using namespace coro;
+
+// mock resp server which understands PING, SET and GET, enough to stand in for redis
+std::unordered_map<std::string, std::string> g_store;
+
+task<> mock_session(int fd)
+{
+    auto         stream = net::buffered_stream(net::tcp_connector(fd));
+    resp::parser parser;
+    while (true)
+    {
+        auto ret = parser.feed(stream.buffered());
+        if (ret < 0)
+        {
+            break;
+        }
+        stream.consume(ret);
+        if (!parser.done())
+        {
+            // replies of all buffered commands go out by one write
+            auto size = stream.buffered().size();
+            if (co_await stream.flush() < 0 || (co_await stream.peek(size + 1)).size() <= size)
+            {
+                break;
+            }
+            continue;
+        }
+
+        auto  cmd  = parser.take();
+        auto& args = cmd.elements;
+        if (args.size() == 1 && args[0].str == "PING")
+        {
+            co_await stream.write("+PONG\r\n");
+        }
+        else if (args.size() == 3 && args[0].str == "SET")
+        {
+            g_store[args[1].str] = args[2].str;
+            co_await stream.write("+OK\r\n");
+        }
+        else if (args.size() == 2 && args[0].str == "GET")
+        {
+            auto it = g_store.find(args[1].str);
+            if (it == g_store.end())
+            {
+                co_await stream.write("$-1\r\n");
+                continue;
+            }
+            auto reply = "$" + std::to_string(it->second.size()) + "\r\n" + it->second + "\r\n";
+            co_await stream.write(reply);
+        }
+        else
+        {
+            co_await stream.write("-ERR unknown command\r\n");
+        }
+    }
+    co_await stream.flush();
+    co_await stream.connector().close();
+}
+
+task<> mock_server(int port)
+{
+    auto server = net::tcp_server(port);
+    int  fd     = co_await server.accept();
+    if (fd >= 0)
+    {
+        co_await mock_session(fd);
+    }
+}
+
+wait_group wg{0};
+
+task<> worker(resp::client& cli, int id)
+{
+    auto key = "key" + std::to_string(id);
+    auto val = "value" + std::to_string(id);
+    co_await cli.command("SET", key, val);
+    auto reply = co_await cli.command("GET", key);
+    log::info("GET {} -> {}", key, reply.str);
+    wg.done();
+}
+
+task<> run_client(int port)
+{
+    resp::client cli("127.0.0.1", port);
+    if (co_await cli.connect() < 0)
+    {
+        log::info("connect error");
+        co_return;
+    }
+    auto pong = co_await cli.command("PING");
+    log::info("PING -> {}", pong.str);
+
+    // workers run on this context, their commands share the connection and are pipelined
+    wg.add(16);
+    for (int i = 0; i < 16; i++)
+    {
+        submit_to_context(worker(cli, i));
+    }
+    co_await wg.wait();
+    co_await cli.close();
+}
+
+int main(int argc, char const* argv[])
+{
+    scheduler::init(1);
+
+    submit_to_scheduler(mock_server(8000));
+    submit_to_scheduler(run_client(8000));
+    scheduler::loop();
+    return 0;
+}
@@ -0,0 +1,25 @@
+#include "coro/coro.hpp"
+
+using namespace coro;
+
+task<> sleeper(int id, int ms)
+{
+    auto start = std::chrono::steady_clock::now();
+    co_await sleep_for(std::chrono::milliseconds(ms));
+    auto cost = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    log::info("task {} sleep {}ms, wake up after {}ms", id, ms, cost.count());
+}
+
+int main(int argc, char const* argv[])
+{
+    /* code */
+    scheduler::init();
+
+    for (int i = 0; i < 10; i++)
+    {
+        submit_to_scheduler(sleeper(i, (10 - i) * 100));
+    }
+
+    scheduler::loop();
+    return 0;
+}
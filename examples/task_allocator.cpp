@@ -0,0 +1,48 @@
+#include <array>
+#include <memory_resource>
+
+#include "coro/coro.hpp"
+
+using namespace coro;
+
+#define TASK_NUM 3
+
+using arena_alloc = std::pmr::polymorphic_allocator<>;
+
+task<int> calc(std::allocator_arg_t, arena_alloc alloc, int lef, int rig)
+{
+    int sum = 0;
+    for (int i = lef; i < rig; i++)
+    {
+        sum += i;
+    }
+    co_return sum;
+}
+
+task<> session(int id)
+{
+    // frames of all sub tasks come from this arena and are released together when session ends
+    std::array<std::byte, 4096>         buf;
+    std::pmr::monotonic_buffer_resource arena(buf.data(), buf.size());
+
+    int sum = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        sum += co_await calc(std::allocator_arg, &arena, i * 10, (i + 1) * 10);
+    }
+    log::info("session {} calc result: {}", id, sum);
+}
+
+int main(int argc, char const* argv[])
+{
+    /* code */
+    scheduler::init();
+
+    for (int i = 0; i < TASK_NUM; i++)
+    {
+        submit_to_scheduler(session(i));
+    }
+
+    scheduler::loop();
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include "coro/coro.hpp"
+
+using namespace coro;
+
+task<> session(int fd)
+{
+    auto conn   = net::tcp_connector(fd);
+    auto stream = conn.recv_multishot();
+    int  ret    = 0;
+    while (true)
+    {
+        auto buf = co_await stream.next();
+        if (buf.result() == -ENOBUFS)
+        {
+            continue;
+        }
+        if (buf.result() <= 0)
+        {
+            break;
+        }
+        ret = co_await conn.write(buf.data(), buf.size());
+        if (ret <= 0)
+        {
+            break;
+        }
+    }
+
+    // stop the running multishot recv before the stream is destroyed
+    co_await stream.cancel();
+    ret = co_await conn.close();
+    log::info("client {} close connect", fd);
+}
+
+task<> server(int port)
+{
+    log::info("server start in {}", port);
+    auto server = net::tcp_server(port);
+    int  client_fd;
+    while ((client_fd = co_await server.accept()) > 0)
+    {
+        submit_to_scheduler(session(client_fd));
+    }
+}
+
+int main(int argc, char const* argv[])
+{
+    scheduler::init();
+
+    submit_to_scheduler(server(8000));
+    scheduler::loop();
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include "coro/coro.hpp"
+
+using namespace coro;
+
+// echo every line back, lines arrived in one read are answered by one write
+task<> session(int fd)
+{
+    auto stream = net::buffered_stream(net::tcp_connector(fd));
+    while (true)
+    {
+        auto line = co_await stream.read_until("\n");
+        if (line.empty() || co_await stream.write(line) < 0)
+        {
+            break;
+        }
+        if (stream.buffered().find('\n') == std::string_view::npos && co_await stream.flush() < 0)
+        {
+            break;
+        }
+    }
+
+    co_await stream.connector().close();
+    log::info("client {} close connect", fd);
+}
+
+task<> server(int port)
+{
+    log::info("server start in {}", port);
+    auto server = net::tcp_server(port);
+    int  client_fd;
+    while ((client_fd = co_await server.accept()) > 0)
+    {
+        submit_to_scheduler(session(client_fd));
+    }
+}
+
+int main(int argc, char const* argv[])
+{
+    scheduler::init();
+
+    submit_to_scheduler(server(8000));
+    scheduler::loop();
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include "coro/coro.hpp"
+
+using namespace coro;
+
+#define BATCH 16
+
+task<> server(int port)
+{
+    log::info("udp server start in {}", port);
+    auto sock = net::udp_socket(nullptr, port);
+    if (sock.fd() < 0)
+    {
+        log::info("udp server bind error: {}", sock.error());
+        co_return;
+    }
+    auto stream = sock.recv_stream();
+
+    net::udp_datagram batch[BATCH];
+    while (true)
+    {
+        auto num = co_await stream.next_batch(batch);
+        for (size_t i = 0; i < num; i++)
+        {
+            auto& dgram = batch[i];
+            if (dgram.result() == -ENOBUFS)
+            {
+                continue;
+            }
+            if (dgram.result() < 0)
+            {
+                log::info("udp server stop, error: {}", dgram.result());
+                co_await stream.cancel();
+                co_return;
+            }
+            if (dgram.from() == nullptr)
+            {
+                continue;
+            }
+            co_await sock.send_to(dgram.data(), dgram.size(), dgram.from());
+        }
+    }
+}
+
+int main(int argc, char const* argv[])
+{
+    /* code */
+    scheduler::init();
+
+    submit_to_scheduler(server(8000));
+    scheduler::loop();
+    return 0;
+}
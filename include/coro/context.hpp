@@ -12,6 +12,7 @@
 
 #include <atomic>
 #include <memory>
+#include <span>
 #include <thread>
 
 #include "config.h"
@@ -106,6 +107,20 @@ public:
      */
     [[CORO_TEST_USED(lab2b)]] auto submit_task(std::coroutine_handle<> handle) noexcept -> void;
 
+    /**
+     * @brief submit a batch of task handles to context through submit_task() with only one wakeup
+     *
+     * @param handles
+     */
+    inline auto submit_batch(std::span<std::coroutine_handle<>> handles) noexcept -> void
+    {
+        detail::engine::wake_batch batch(m_engine);
+        for (auto handle : handles)
+        {
+            submit_task(handle);
+        }
+    }
+
     /**
      * @brief get context unique id
      *
@@ -132,10 +147,22 @@ public:
     /**
      * @brief main logic of work thread
      *
+     * @note run loop should wait on an empty engine by engine::park(), which calls
+     * try_steal() first in work stealing mode
+     *
      * @param token
      */
     [[CORO_TEST_USED(lab2b)]] auto run(stop_token token) noexcept -> void;
 
+    /**
+     * @brief steal a batch of task handles from sibling contexts of scheduler
+     *
+     * @note must be called by work thread, only used in work stealing mode
+     *
+     * @return true if any task is stolen
+     */
+    auto try_steal() noexcept -> bool;
+
     // TODO[lab2b]: Add more function if you need
 
 private:
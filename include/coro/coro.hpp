@@ -7,7 +7,16 @@
 #include "coro/comp/mutex.hpp"
 #include "coro/comp/wait_group.hpp"
 #include "coro/comp/when_all.hpp"
+#include "coro/fs/file.hpp"
+#include "coro/http/server.hpp"
 #include "coro/log.hpp"
+#include "coro/net/buffered_stream.hpp"
+#include "coro/net/io_guard.hpp"
+#include "coro/net/io_link.hpp"
 #include "coro/net/tcp.hpp"
+#include "coro/net/udp.hpp"
+#include "coro/net/unix.hpp"
+#include "coro/resp/client.hpp"
 #include "coro/scheduler.hpp"
+#include "coro/timer.hpp"
 #include "coro/utils.hpp"
\ No newline at end of file
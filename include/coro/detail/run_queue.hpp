@@ -0,0 +1,168 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "config.h"
+#include "coro/detail/steal_queue.hpp"
+
+namespace coro::detail
+{
+using std::coroutine_handle;
+
+/**
+ * @brief run queue of tasks submitted to an engine by its owner thread, tasks submitted by other
+ * threads stay in the injection queue of engine
+ *
+ * @note with lifo_slot the task woken last runs next, at most config::kLifoStarveLimit times in a row,
+ * then the wakeup goes to the back of queue
+ *
+ * @note with work_stealing tasks are kept in a deque siblings can steal from, owner takes the oldest
+ * task like thieves do, so a task re-submitting itself goes behind every queued task, and one task of
+ * injection queue goes first every config::kInjectCheckInterval pops, so neither older local tasks
+ * nor tasks of other threads starve
+ *
+ * @note steal() is thread-safe, other functions can only be called by owner thread
+ *
+ * @tparam lifo_slot
+ * @tparam work_stealing
+ * @tparam capacity capacity of local deque, must be power of two
+ */
+template<bool lifo_slot, bool work_stealing, size_t capacity = config::kQueCap>
+class run_queue
+{
+public:
+    run_queue() noexcept = default;
+
+    run_queue(const run_queue&)                    = delete;
+    run_queue(run_queue&&)                         = delete;
+    auto operator=(const run_queue&) -> run_queue& = delete;
+    auto operator=(run_queue&&) -> run_queue&      = delete;
+
+    /**
+     * @brief keep a task woken by owner thread, return false if the task must go to injection queue,
+     * then handle is set to that task, which may be the one displaced from lifo slot
+     *
+     * @param handle
+     * @return true
+     * @return false
+     */
+    auto push(coroutine_handle<>& handle) noexcept -> bool
+    {
+        if constexpr (lifo_slot)
+        {
+            // the slot runs ahead of every queued task, so once the streak reaches the limit
+            // wakeup goes to the back of queue
+            if (m_streak < config::kLifoStarveLimit)
+            {
+                handle = std::exchange(m_next, handle);
+                if (!handle)
+                {
+                    return true;
+                }
+            }
+        }
+        if constexpr (work_stealing)
+        {
+            return m_local.push(handle);
+        }
+        return false;
+    }
+
+    /**
+     * @brief push handle to the back of local deque bypassing lifo slot, return false if it is full
+     *
+     * @param handle
+     * @return true
+     * @return false
+     */
+    auto push_back(coroutine_handle<> handle) noexcept -> bool
+    {
+        if constexpr (work_stealing)
+        {
+            return m_local.push(handle);
+        }
+        return false;
+    }
+
+    /**
+     * @brief pop the next task to run, return false if local deque is empty and injection queue
+     * isn't due or is empty
+     *
+     * @note caller still drains injection queue once this returns false
+     *
+     * @tparam queue_type injection queue, provides try_pop(coroutine_handle<>&)
+     * @param handle
+     * @param inject
+     * @return true
+     * @return false
+     */
+    template<typename queue_type>
+    auto pop(coroutine_handle<>& handle, queue_type& inject) noexcept -> bool
+    {
+        if constexpr (work_stealing)
+        {
+            if (++m_tick >= config::kInjectCheckInterval)
+            {
+                m_tick = 0;
+                if (inject.try_pop(handle))
+                {
+                    return true;
+                }
+            }
+        }
+        if constexpr (lifo_slot)
+        {
+            if (m_next)
+            {
+                m_streak++;
+                handle = std::exchange(m_next, nullptr);
+                return true;
+            }
+            m_streak = 0;
+        }
+        if constexpr (work_stealing)
+        {
+            // owner competes with thieves at the front, a lost race means another task is left
+            while (!m_local.empty())
+            {
+                if (m_local.try_steal(handle))
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief steal the oldest task of local deque
+     *
+     * @note thread-safe
+     *
+     * @param handle
+     * @return true
+     * @return false
+     */
+    auto steal(coroutine_handle<>& handle) noexcept -> bool { return m_local.try_steal(handle); }
+
+    /**
+     * @brief return the approximate number of tasks in local deque, lifo slot isn't counted
+     *
+     * @return size_t
+     */
+    inline auto size() const noexcept -> size_t { return m_local.size(); }
+
+    inline auto empty() const noexcept -> bool { return !m_next && m_local.empty(); }
+
+private:
+    steal_queue<coroutine_handle<>, capacity> m_local;
+    uint32_t                                  m_tick{0}; // pops since injection queue was checked
+
+    coroutine_handle<> m_next{nullptr};
+    uint32_t           m_streak{0}; // tasks run from lifo slot in a row
+};
+
+}; // namespace coro::detail
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "config.h"
+#include "coro/attribute.hpp"
+
+namespace coro::detail
+{
+using std::array;
+using std::atomic;
+using std::memory_order_acquire;
+using std::memory_order_relaxed;
+using std::memory_order_release;
+using std::memory_order_seq_cst;
+
+/**
+ * @brief fixed capacity chase-lev deque, the owner thread push and pop at the bottom,
+ * other threads steal at the top
+ *
+ * @tparam T storage_type, must be trivially copyable such as coroutine_handle<>
+ * @tparam capacity must be power of two
+ *
+ * @note push() and try_pop() can only be called by the owner thread,
+ * try_steal() is thread-safe
+ */
+template<typename T, size_t capacity = config::kQueCap>
+    requires(std::has_single_bit(capacity))
+class steal_queue
+{
+public:
+    steal_queue() noexcept = default;
+
+    steal_queue(const steal_queue&)                    = delete;
+    steal_queue(steal_queue&&)                         = delete;
+    auto operator=(const steal_queue&) -> steal_queue& = delete;
+    auto operator=(steal_queue&&) -> steal_queue&      = delete;
+
+    /**
+     * @brief push value to bottom, return false if queue is full
+     *
+     * @note only called by owner thread
+     */
+    auto push(T value) noexcept -> bool
+    {
+        auto b = m_bottom.load(memory_order_relaxed);
+        auto t = m_top.load(memory_order_acquire);
+        if (b - t >= static_cast<int64_t>(capacity))
+        {
+            return false;
+        }
+        m_buf[b & kMask].store(value, memory_order_relaxed);
+        std::atomic_thread_fence(memory_order_release);
+        m_bottom.store(b + 1, memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief pop value from bottom, return false if queue is empty
+     *
+     * @note only called by owner thread
+     */
+    auto try_pop(T& value) noexcept -> bool
+    {
+        auto b = m_bottom.load(memory_order_relaxed) - 1;
+        m_bottom.store(b, memory_order_relaxed);
+        std::atomic_thread_fence(memory_order_seq_cst);
+        auto t = m_top.load(memory_order_relaxed);
+
+        if (t > b)
+        {
+            // queue is empty, restore bottom
+            m_bottom.store(b + 1, memory_order_relaxed);
+            return false;
+        }
+
+        value = m_buf[b & kMask].load(memory_order_relaxed);
+        if (t == b)
+        {
+            // last element, race with thieves
+            bool win = m_top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+            m_bottom.store(b + 1, memory_order_relaxed);
+            return win;
+        }
+        return true;
+    }
+
+    /**
+     * @brief steal value from top, return false if queue is empty or lose the race
+     *
+     * @note thread-safe
+     */
+    auto try_steal(T& value) noexcept -> bool
+    {
+        auto t = m_top.load(memory_order_acquire);
+        std::atomic_thread_fence(memory_order_seq_cst);
+        auto b = m_bottom.load(memory_order_acquire);
+
+        if (t >= b)
+        {
+            return false;
+        }
+
+        value = m_buf[t & kMask].load(memory_order_relaxed);
+        return m_top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+    }
+
+    /**
+     * @brief return the approximate number of elements
+     *
+     */
+    auto size() const noexcept -> size_t
+    {
+        auto b = m_bottom.load(memory_order_relaxed);
+        auto t = m_top.load(memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+    inline auto empty() const noexcept -> bool { return size() == 0; }
+
+private:
+    static constexpr int64_t kMask = capacity - 1;
+
+    CORO_ALIGN atomic<int64_t> m_top{0};
+    CORO_ALIGN atomic<int64_t> m_bottom{0};
+    array<atomic<T>, capacity> m_buf;
+};
+
+}; // namespace coro::detail
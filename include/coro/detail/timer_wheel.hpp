@@ -0,0 +1,196 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+
+namespace coro::detail
+{
+using std::array;
+
+/**
+ * @brief intrusive timer node, lives in the awaiter of the sleeping coroutine
+ *
+ */
+struct timer_node
+{
+    timer_node*             next{nullptr};
+    uint64_t                expire{0}; // tick
+    std::coroutine_handle<> handle{nullptr};
+};
+
+/**
+ * @brief hierarchical timer wheel, each level has kSlotNum slots and a slot of level l covers
+ * kSlotNum^l ticks, timers in a slot of higher level are moved down when current tick enters
+ * the slot, so adding and firing a timer are both O(1)
+ *
+ * @note not thread-safe, only used by owner engine
+ */
+class timer_wheel
+{
+public:
+    static constexpr size_t kLevelBits = 6;
+    static constexpr size_t kSlotNum   = 1 << kLevelBits;
+    static constexpr size_t kLevelNum  = 4;
+
+    static constexpr uint64_t kNever = UINT64_MAX;
+
+    inline auto empty() const noexcept -> bool { return m_size == 0; }
+
+    inline auto size() const noexcept -> size_t { return m_size; }
+
+    inline auto now() const noexcept -> uint64_t { return m_now; }
+
+    /**
+     * @brief set current tick, only called when wheel is empty
+     *
+     */
+    inline auto reset(uint64_t now) noexcept -> void { m_now = now; }
+
+    /**
+     * @brief add timer, timer expired already fires at the next tick
+     *
+     */
+    auto add(timer_node* node) noexcept -> void
+    {
+        if (node->expire <= m_now)
+        {
+            node->expire = m_now + 1;
+        }
+        m_size++;
+        place(node);
+    }
+
+    /**
+     * @brief move current tick to now and call fire(node) for every expired timer
+     *
+     */
+    template<typename fire_func>
+    auto advance(uint64_t now, fire_func&& fire) noexcept -> void
+    {
+        while (m_now < now && m_size > 0)
+        {
+            // skip ticks without work, no window of an occupied level is crossed by this
+            auto next = next_expire();
+            if (next > now)
+            {
+                break;
+            }
+            m_now = next;
+            cascade();
+
+            auto& slot = m_slots[0][m_now & kSlotMask];
+            auto  node = slot;
+            slot       = nullptr;
+            while (node != nullptr)
+            {
+                auto next = node->next;
+                m_size--;
+                fire(node);
+                node = next;
+            }
+        }
+        if (m_now < now)
+        {
+            m_now = now;
+        }
+    }
+
+    /**
+     * @brief return the earliest tick at which advance() has work to do, kNever if wheel is empty
+     *
+     * @note for timers in higher levels this is the tick they are moved down, which is no later
+     * than their expire tick
+     */
+    auto next_expire() const noexcept -> uint64_t
+    {
+        if (m_size == 0)
+        {
+            return kNever;
+        }
+
+        uint64_t ret = m_overflow != nullptr ? ((m_now >> kTotalBits) + 1) << kTotalBits : kNever;
+        for (size_t level = 0; level < kLevelNum; level++)
+        {
+            auto shift = level * kLevelBits;
+            auto cur   = (m_now >> shift) & kSlotMask;
+            // timers of a level always sit behind the current slot of the same window
+            for (auto idx = cur + 1; idx < kSlotNum; idx++)
+            {
+                if (m_slots[level][idx] != nullptr)
+                {
+                    auto window = (m_now >> (shift + kLevelBits)) << (shift + kLevelBits);
+                    auto tick   = window | (idx << shift);
+                    ret         = tick < ret ? tick : ret;
+                    break;
+                }
+            }
+        }
+        return ret;
+    }
+
+private:
+    static constexpr uint64_t kSlotMask  = kSlotNum - 1;
+    static constexpr size_t   kTotalBits = kLevelBits * kLevelNum;
+
+    // put node into the level of the highest bit where expire and current tick differ
+    auto place(timer_node* node) noexcept -> void
+    {
+        auto diff = node->expire ^ m_now;
+        if ((diff >> kTotalBits) != 0)
+        {
+            node->next = m_overflow;
+            m_overflow = node;
+            return;
+        }
+
+        size_t level = diff == 0 ? 0 : (std::bit_width(diff) - 1) / kLevelBits;
+        auto&  slot  = m_slots[level][(node->expire >> (level * kLevelBits)) & kSlotMask];
+        node->next   = slot;
+        slot         = node;
+    }
+
+    // move timers of the slots current tick just enters down to lower levels
+    auto cascade() noexcept -> void
+    {
+        if ((m_now & ((uint64_t(1) << kTotalBits) - 1)) == 0)
+        {
+            auto node  = m_overflow;
+            m_overflow = nullptr;
+            relink(node);
+        }
+
+        for (size_t level = kLevelNum - 1; level > 0; level--)
+        {
+            auto shift = level * kLevelBits;
+            if ((m_now & ((uint64_t(1) << shift) - 1)) != 0)
+            {
+                continue;
+            }
+            auto& slot = m_slots[level][(m_now >> shift) & kSlotMask];
+            auto  node = slot;
+            slot       = nullptr;
+            relink(node);
+        }
+    }
+
+    inline auto relink(timer_node* node) noexcept -> void
+    {
+        while (node != nullptr)
+        {
+            auto next = node->next;
+            place(node);
+            node = next;
+        }
+    }
+
+private:
+    array<array<timer_node*, kSlotNum>, kLevelNum> m_slots{};
+    timer_node*                                    m_overflow{nullptr};
+    uint64_t                                       m_now{0};
+    size_t                                         m_size{0};
+};
+
+}; // namespace coro::detail
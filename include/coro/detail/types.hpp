@@ -6,17 +6,20 @@
 namespace coro::detail
 {
 
-// TODO: Add lifo and fifo strategy support
 enum class schedule_strategy : uint8_t
 {
     fifo, // default
-    lifo,
+    lifo, // task woken by engine's own thread runs next
     none
 };
 
 enum class dispatch_strategy : uint8_t
 {
     round_robin,
+    work_stealing, // round robin dispatch, idle context steal task from siblings
+    least_loaded,  // context with the fewest queued tasks and running io
+    power_of_two,  // the less loaded one of two random contexts
+    locality,      // keep task submitted by context on that context
     none
 };
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -74,4 +75,171 @@ private:
     std::atomic<size_t> m_cur{0};
 };
 
+/**
+ * @brief work stealing places new task by round robin, then idle
+ * contexts balance load by stealing from their siblings
+ *
+ * @tparam
+ */
+template<>
+class dispatcher<dispatch_strategy::work_stealing> : public dispatcher<dispatch_strategy::round_robin>
+{
+};
+
+/**
+ * @brief return the load of context, used by load aware strategies
+ *
+ * @note this is called by submitting thread, so engine::num_task_schedule() must be thread-safe
+ *
+ * @param ctx
+ * @return size_t
+ */
+inline auto ctx_load(context& ctx) noexcept -> size_t
+{
+    auto& egn = ctx.get_engine();
+    return egn.num_task_schedule() + egn.num_io_inflight();
+}
+
+// load aware dispatchers read load through this, tests replace it to set the load of each context
+struct ctx_load_reader
+{
+    inline auto operator()(context& ctx) const noexcept -> size_t { return ctx_load(ctx); }
+};
+
+/**
+ * @brief least loaded scans all contexts and choose the one with the smallest load
+ *
+ * @tparam load_reader
+ */
+template<typename load_reader = ctx_load_reader>
+class least_loaded_dispatcher
+{
+public:
+    void init(size_t ctx_cnt, ctx_container* ctxs) noexcept
+    {
+        m_ctx_cnt = ctx_cnt;
+        m_ctxs    = ctxs;
+        m_cur     = 0;
+    }
+
+    auto dispatch() noexcept -> size_t
+    {
+        // scan from a rotating start so that ties are broken like round robin
+        size_t start     = m_cur.fetch_add(1, std::memory_order_relaxed) % m_ctx_cnt;
+        size_t best      = start;
+        size_t best_load = load_reader{}(*(*m_ctxs)[start]);
+        for (size_t i = 1; i < m_ctx_cnt && best_load > 0; i++)
+        {
+            size_t idx  = (start + i) % m_ctx_cnt;
+            size_t load = load_reader{}(*(*m_ctxs)[idx]);
+            if (load < best_load)
+            {
+                best      = idx;
+                best_load = load;
+            }
+        }
+        return best;
+    }
+
+private:
+    size_t              m_ctx_cnt;
+    ctx_container*      m_ctxs;
+    std::atomic<size_t> m_cur{0};
+};
+
+template<>
+class dispatcher<dispatch_strategy::least_loaded> : public least_loaded_dispatcher<>
+{
+};
+
+/**
+ * @brief power of two random choices samples two contexts and choose the less loaded one,
+ * which is close to least loaded but only reads two contexts
+ *
+ * @tparam load_reader
+ */
+template<typename load_reader = ctx_load_reader>
+class power_of_two_dispatcher
+{
+public:
+    void init(size_t ctx_cnt, ctx_container* ctxs) noexcept
+    {
+        m_ctx_cnt = ctx_cnt;
+        m_ctxs    = ctxs;
+    }
+
+    auto dispatch() noexcept -> size_t
+    {
+        if (m_ctx_cnt == 1)
+        {
+            return 0;
+        }
+
+        size_t a = next_rand() % m_ctx_cnt;
+        size_t b = next_rand() % (m_ctx_cnt - 1);
+        if (b >= a)
+        {
+            b++;
+        }
+        return load_reader{}(*(*m_ctxs)[a]) <= load_reader{}(*(*m_ctxs)[b]) ? a : b;
+    }
+
+private:
+    // xorshift64, each thread owns its state so dispatch needs no synchronization
+    static auto next_rand() noexcept -> uint64_t
+    {
+        thread_local uint64_t state = reinterpret_cast<uintptr_t>(&state) | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+private:
+    size_t         m_ctx_cnt;
+    ctx_container* m_ctxs;
+};
+
+template<>
+class dispatcher<dispatch_strategy::power_of_two> : public power_of_two_dispatcher<>
+{
+};
+
+/**
+ * @brief locality keeps task submitted by context on that context to make use of
+ * warm cache, task submitted by other threads is dispatched by round robin
+ *
+ * @tparam
+ */
+template<>
+class dispatcher<dispatch_strategy::locality>
+{
+public:
+    void init(size_t ctx_cnt, ctx_container* ctxs) noexcept
+    {
+        m_ctx_cnt = ctx_cnt;
+        m_ctxs    = ctxs;
+        m_cur     = 0;
+    }
+
+    auto dispatch() noexcept -> size_t
+    {
+        auto ctx = linfo.ctx;
+        if (ctx != nullptr)
+        {
+            auto id = ctx->get_ctx_id();
+            if (id < m_ctx_cnt && (*m_ctxs)[id].get() == ctx)
+            {
+                return id;
+            }
+        }
+        return m_cur.fetch_add(1, std::memory_order_relaxed) % m_ctx_cnt;
+    }
+
+private:
+    size_t              m_ctx_cnt;
+    ctx_container*      m_ctxs;
+    std::atomic<size_t> m_cur{0};
+};
+
 }; // namespace coro::detail
@@ -12,14 +12,20 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <coroutine>
 #include <functional>
 #include <queue>
+#include <span>
+#include <utility>
 
 #include "config.h"
 #include "coro/atomic_que.hpp"
 #include "coro/attribute.hpp"
+#include "coro/detail/run_queue.hpp"
+#include "coro/detail/timer_wheel.hpp"
 #include "coro/meta_info.hpp"
+#include "coro/net/io_info.hpp"
 #include "coro/uring_proxy.hpp"
 
 namespace coro
@@ -48,6 +54,7 @@ using std::array;
 using std::atomic;
 using std::coroutine_handle;
 using std::queue;
+using uring::kMsgRingTag;
 using uring::urcptr;
 using uring::uring_proxy;
 using uring::ursptr;
@@ -56,6 +63,22 @@ template<typename T>
 // multi producer and multi consumer queue
 using mpmc_queue = AtomicQueue<T>;
 
+// if true, engine keeps tasks submitted by its own thread in a local deque which siblings can steal
+inline constexpr bool kWorkStealing = config::kDispatchStrategy == dispatch_strategy::work_stealing;
+
+// if true, engine records running io number so that dispatcher can read its load
+inline constexpr bool kTrackIoLoad = config::kDispatchStrategy == dispatch_strategy::least_loaded ||
+                                     config::kDispatchStrategy == dispatch_strategy::power_of_two;
+
+// if true, task submitted by other threads is posted to engine's uring by IORING_OP_MSG_RING
+inline constexpr bool kMsgRingWakeUp = config::kMsgRingWakeUp;
+
+// if true, engine runs the task woken by its own thread before the queued tasks
+inline constexpr bool kLifoSlot = config::kScheduleStrategy == schedule_strategy::lifo;
+
+// if true, engine keeps tasks submitted by its own thread in run queue rather than task queue
+inline constexpr bool kOwnerRunQueue = kLifoSlot || kWorkStealing;
+
 class engine
 {
     friend class ::coro::context;
@@ -90,6 +113,31 @@ public:
      */
     [[CORO_DISCARD_HINT]] auto get_free_urs() noexcept -> ursptr;
 
+    /**
+     * @brief get a sqe entry, if uring has no free sqe, return a staged sqe instead, the staged sqe
+     * is put into overflow list by the following add_io_submit() and moved into uring by poll_submit()
+     * once uring has free slots, so io submitter never fails
+     *
+     * @note the returned sqe must be followed by add_io_submit() before next get_sqe()
+     *
+     * @note sqes linked by IOSQE_IO_LINK must be passed to seal_chain() once they are all prepared
+     *
+     * @return ursptr never nullptr
+     */
+    [[CORO_DISCARD_HINT]] auto get_sqe() noexcept -> ursptr;
+
+    /**
+     * @brief keep the sqes of an IOSQE_IO_LINK chain in one submission, uring may become full in the
+     * middle of the chain, then the leading sqes already in uring are moved into overflow list and
+     * their slots turn to nop, so the whole chain is staged and moved into uring only when it fits
+     *
+     * @note chain must be taken by get_sqe() in order without other sqe in between, and sealed right
+     * after its last add_io_submit(), sqe of chain mustn't be touched after that
+     *
+     * @param chain
+     */
+    auto seal_chain(std::span<ursptr> chain) noexcept -> void;
+
     /**
      * @brief return number of task to run in engine
      *
@@ -107,10 +155,94 @@ public:
     /**
      * @brief submit one task handle to engine
      *
+     * @note engine should be woken up by wake_up(), so a wake_batch scope can merge the wakeups
+     *
      * @param handle
      */
     [[CORO_TEST_USED(lab2a)]] auto submit_task(coroutine_handle<> handle) noexcept -> void;
 
+    /**
+     * @brief submit a batch of task handles to engine through submit_task(),
+     * engine will be woken up only once
+     *
+     * @param handles
+     */
+    auto submit_batch(std::span<coroutine_handle<>> handles) noexcept -> void;
+
+    /**
+     * @brief wake_batch defers wake_up() of one engine made by the current thread until the scope ends,
+     * then wakes the engine once if any wakeup was deferred
+     *
+     */
+    class wake_batch
+    {
+    public:
+        explicit wake_batch(engine& egn) noexcept
+            : m_prev(std::exchange(t_batch, &egn)),
+              m_prev_woken(std::exchange(t_batch_woken, false))
+        {
+        }
+
+        ~wake_batch() noexcept
+        {
+            auto egn   = std::exchange(t_batch, m_prev);
+            bool woken = std::exchange(t_batch_woken, m_prev_woken);
+            if (woken)
+            {
+                egn->wake_up();
+            }
+        }
+
+        wake_batch(const wake_batch&)                    = delete;
+        auto operator=(const wake_batch&) -> wake_batch& = delete;
+
+    private:
+        engine* m_prev;
+        bool    m_prev_woken;
+    };
+
+    /**
+     * @brief wake up engine which may be blocked in waiting eventfd
+     *
+     * @note if config::kLazyWakeUp is true, eventfd is written only when engine is parked,
+     * so submitting to a running engine costs no syscall
+     *
+     * @note if engine is parked in its uring, eventfd write wakes it up by the multishot poll on eventfd
+     */
+    inline auto wake_up() noexcept -> void
+    {
+        if (t_batch == this)
+        {
+            t_batch_woken = true;
+            return;
+        }
+        if constexpr (config::kLazyWakeUp)
+        {
+            // pairs with the fence in park(), either we see the sleeping flag or park sees our task
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!m_sleeping.load(std::memory_order_relaxed) || !m_sleeping.exchange(false, std::memory_order_acq_rel))
+            {
+                return;
+            }
+        }
+        m_upxy.write_eventfd(1);
+    }
+
+    /**
+     * @brief spin for config::kParkSpinRounds rounds waiting new task or finished io,
+     * then mark engine as sleeping and block in waiting eventfd
+     *
+     * @note use this instead of uring_proxy::wait_eventfd() when config::kLazyWakeUp is true
+     *
+     * @note in work stealing mode engine first tries to steal tasks from sibling contexts
+     *
+     * @note if tasks are posted by IORING_OP_MSG_RING, engine blocks in its uring rather than eventfd,
+     * so a posted task wakes it up by its cqe entry, and the failed posts of this thread are reaped first
+     *
+     * @return uint64_t eventfd value, 0 means engine didn't block, 1 if engine blocked in its uring
+     */
+    auto park() noexcept -> uint64_t;
+
     /**
      * @brief this will call schedule() to fetch one task handle and run it
      *
@@ -129,6 +261,9 @@ public:
      * @brief submit uring sqe and wait uring finish, then handle
      * cqe entry by call handle_cqe_entry
      *
+     * @note multishot io produces many cqe entries for one sqe, io isn't finished until
+     * the cqe entry without IORING_CQE_F_MORE
+     *
      */
     [[CORO_TEST_USED(lab2a)]] auto poll_submit() noexcept -> void;
 
@@ -145,6 +280,9 @@ public:
      * @note submit_io: io to be submitted
      * @note running_io: io is submitted but it has't run finished
      *
+     * @note task posted by IORING_OP_MSG_RING but not yet reaped counts as running io,
+     * so engine doesn't stop while the task is still in its completion queue
+     *
      * @return true
      * @return false
      */
@@ -157,6 +295,55 @@ public:
      */
     inline auto get_id() noexcept -> uint32_t { return m_id; }
 
+    /**
+     * @brief return the uring proxy of engine
+     *
+     * @return uring_proxy&
+     */
+    inline auto get_uring() noexcept -> uring_proxy& { return m_upxy; }
+
+    /**
+     * @brief steal at most batch task handles from victim and push them to local deque
+     *
+     * @note must be called by the thread owning this engine, only used in work stealing mode
+     *
+     * @param victim
+     * @param batch
+     * @return size_t number of stolen task handles
+     */
+    auto steal_from(engine& victim, size_t batch = config::kStealBatchSize) noexcept -> size_t;
+
+    /**
+     * @brief return approximate number of io submitted but not finished
+     *
+     * @note thread-safe, only tracked by load aware dispatch strategy
+     *
+     * @return size_t
+     */
+    inline auto num_io_inflight() const noexcept -> size_t { return m_io_inflight.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief add timer to timer wheel, the coroutine of node is submitted to engine after deadline
+     *
+     * @note must be called by the thread owning this engine
+     *
+     * @param node
+     * @param deadline
+     */
+    auto add_timer(timer_node* node, std::chrono::steady_clock::time_point deadline) noexcept -> void;
+
+    /**
+     * @brief return how many times io is staged in overflow list because uring is full
+     *
+     * @note thread-safe
+     *
+     * @return uint64_t
+     */
+    inline auto num_io_overflow() const noexcept -> uint64_t
+    {
+        return m_overflow_cnt.load(std::memory_order_relaxed);
+    }
+
     // TODO[lab2a]: Add more function if you need
 
 private:
@@ -166,9 +353,61 @@ private:
     // store task handle
     mpmc_queue<coroutine_handle<>> m_task_queue; // You can replace it with another data structure
 
+    // store task handle submitted by owner thread in lifo or work stealing mode, m_task_queue acts as
+    // the injection queue for other threads
+    run_queue<kLifoSlot, kWorkStealing> m_run_que;
+
+    // only written by owner thread, read by dispatcher
+    atomic<size_t> m_io_inflight{0};
+
+    // tasks posted to this engine by IORING_OP_MSG_RING whose cqe isn't reaped, written by submitters
+    CORO_ALIGN atomic<size_t> m_msg_inflight{0};
+
+    // fail handler of IORING_OP_MSG_RING post, push the task to task queue of target engine and wake it up
+    static auto msg_ring_failed(void* target, uint64_t data) noexcept -> void;
+
+    // true if engine is blocked in waiting eventfd, submitters clear it when they wake engine up
+    CORO_ALIGN atomic<bool> m_sleeping{false};
+
+    // engine whose wakeups are deferred by the wake_batch of current thread
+    inline static thread_local engine* t_batch{nullptr};
+    inline static thread_local bool    t_batch_woken{false};
+
     // used to fetch cqe entry
     array<urcptr, config::kQueCap> m_urc;
 
+    struct overflow_node
+    {
+        io_uring_sqe   sqe;
+        overflow_node* next{nullptr};
+        size_t         chain{1}; // number of linked sqes starting from this node, only set on chain head
+    };
+
+    // move staged sqe entries into uring until the next entry or chain doesn't fit
+    auto flush_overflow() noexcept -> void;
+
+    // completes the nop left in uring by seal_chain()
+    net::detail::io_info m_nop_info;
+
+    // io staged because uring is full, only accessed by owner thread
+    overflow_node*   m_staging{nullptr}; // returned by get_sqe(), waiting for add_io_submit()
+    overflow_node*   m_overflow_head{nullptr};
+    overflow_node*   m_overflow_tail{nullptr};
+    atomic<uint64_t> m_overflow_cnt{0};
+
+    // arm or bring forward the kernel timeout to the next expire tick of timer wheel
+    auto arm_timer() noexcept -> void;
+
+    static auto timer_callback(net::detail::io_info* data, int res) noexcept -> void;
+
+    // timer wheel and its kernel timeout, only accessed by owner thread
+    timer_wheel          m_timer;
+    net::detail::io_info m_timer_info;
+    net::detail::io_info m_timer_update_info;
+    __kernel_timespec    m_timer_ts;
+    __kernel_timespec    m_timer_update_ts;
+    uint64_t             m_timer_armed{timer_wheel::kNever}; // tick the kernel timeout fires at
+
     // TODO[lab2a]: Add more member variables if you need
 };
 
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "config.h"
+#include "coro/attribute.hpp"
+
+namespace coro::detail
+{
+using std::array;
+using std::atomic;
+
+/**
+ * @brief frame_pool caches coroutine frames in size class freelists, each thread owns one pool,
+ * so frames recycled on the same context don't go through global operator new
+ *
+ * @note every block starts with a header recording its owner pool, a block freed by another
+ * thread is pushed to the owner's remote list and reused after the owner drains it
+ *
+ * @note pools are never destroyed, pool of an exited thread is adopted by the next new thread
+ */
+class frame_pool
+{
+    struct block_header
+    {
+        frame_pool* owner; // nullptr means block is allocated by global operator new directly
+        uint32_t    cls;
+        uint32_t    reserved;
+    };
+
+    struct free_node
+    {
+        free_node* next;
+    };
+
+    static constexpr size_t kHeaderSize   = sizeof(block_header);
+    static constexpr size_t kMinClassSize = 64;
+    static constexpr size_t kClassNum     = std::countr_zero(config::kFramePoolMaxSize / kMinClassSize) + 1;
+
+    static_assert(kHeaderSize % __STDCPP_DEFAULT_NEW_ALIGNMENT__ == 0, "frame must keep default new alignment");
+    static_assert(std::has_single_bit(config::kFramePoolMaxSize) && config::kFramePoolMaxSize >= kMinClassSize);
+
+public:
+    frame_pool() noexcept = default;
+
+    frame_pool(const frame_pool&)                    = delete;
+    frame_pool(frame_pool&&)                         = delete;
+    auto operator=(const frame_pool&) -> frame_pool& = delete;
+    auto operator=(frame_pool&&) -> frame_pool&      = delete;
+
+    /**
+     * @brief allocate memory of size bytes from local thread pool
+     *
+     * @param size
+     * @return void*
+     */
+    static auto allocate(size_t size) -> void*
+    {
+        size_t total = size + kHeaderSize;
+        auto   pool  = local();
+        if (total > config::kFramePoolMaxSize || pool == nullptr) [[unlikely]]
+        {
+            auto header   = static_cast<block_header*>(::operator new(total));
+            header->owner = nullptr;
+            return header + 1;
+        }
+        return pool->allocate_cls(class_of(total));
+    }
+
+    /**
+     * @brief return memory allocated by allocate() to its owner pool
+     *
+     * @param ptr
+     */
+    static auto deallocate(void* ptr) noexcept -> void
+    {
+        auto header = static_cast<block_header*>(ptr) - 1;
+        auto owner  = header->owner;
+        if (owner == nullptr)
+        {
+            ::operator delete(header);
+        }
+        else if (owner == t_pool) [[likely]]
+        {
+            owner->push_local(static_cast<free_node*>(ptr), header->cls);
+        }
+        else
+        {
+            owner->push_remote(static_cast<free_node*>(ptr));
+        }
+    }
+
+private:
+    static inline auto class_of(size_t total) noexcept -> uint32_t
+    {
+        return std::bit_width((total - 1) | (kMinClassSize - 1)) - std::countr_zero(kMinClassSize);
+    }
+
+    static inline auto local() noexcept -> frame_pool*
+    {
+        if (t_pool != nullptr) [[likely]]
+        {
+            return t_pool;
+        }
+        return t_exited ? nullptr : acquire_local();
+    }
+
+    auto allocate_cls(uint32_t cls) -> void*
+    {
+        if (m_free[cls] == nullptr && m_remote.load(std::memory_order_relaxed) != nullptr)
+        {
+            drain_remote();
+        }
+
+        if (auto node = m_free[cls]; node != nullptr)
+        {
+            m_free[cls] = node->next;
+            m_free_cnt[cls]--;
+            return node;
+        }
+
+        auto header   = static_cast<block_header*>(::operator new(kMinClassSize << cls));
+        header->owner = this;
+        header->cls   = cls;
+        return header + 1;
+    }
+
+    inline auto push_local(free_node* node, uint32_t cls) noexcept -> void
+    {
+        if (m_free_cnt[cls] >= config::kFramePoolCacheNum)
+        {
+            ::operator delete(reinterpret_cast<block_header*>(node) - 1);
+            return;
+        }
+        node->next  = m_free[cls];
+        m_free[cls] = node;
+        m_free_cnt[cls]++;
+    }
+
+    inline auto push_remote(free_node* node) noexcept -> void
+    {
+        node->next = m_remote.load(std::memory_order_relaxed);
+        while (!m_remote.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+            ;
+    }
+
+    // move blocks freed by other threads to local freelists
+    auto drain_remote() noexcept -> void;
+
+    // free all cached blocks
+    auto release_cache() noexcept -> void;
+
+    // bind a pool to current thread, return nullptr if allocation fails
+    static auto acquire_local() noexcept -> frame_pool*;
+
+    // unbind pool from exiting thread
+    static auto release_local(frame_pool* pool) noexcept -> void;
+
+    friend struct frame_pool_holder;
+
+private:
+    array<free_node*, kClassNum> m_free{};
+    array<size_t, kClassNum>     m_free_cnt{};
+    CORO_ALIGN atomic<free_node*> m_remote{nullptr};
+
+    // trivially destructible, so they are safe to read while thread is exiting
+    inline static thread_local frame_pool* t_pool{nullptr};
+    inline static thread_local bool        t_exited{false};
+};
+
+}; // namespace coro::detail
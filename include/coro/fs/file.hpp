@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdlib>
+#include <utility>
+
+#include "coro/fs/fs_awaiter.hpp"
+
+namespace coro::fs
+{
+// alignment required by O_DIRECT on most block devices
+constexpr size_t kDirectAlign = 4096;
+
+/**
+ * @brief aligned_buffer owns memory whose address and size are both aligned,
+ * which is required by file opened with O_DIRECT
+ *
+ * @note size is rounded up to align
+ */
+class aligned_buffer
+{
+public:
+    aligned_buffer() noexcept = default;
+    explicit aligned_buffer(size_t size, size_t align = kDirectAlign) noexcept
+        : m_size((size + align - 1) / align * align),
+          m_data(static_cast<char*>(std::aligned_alloc(align, m_size)))
+    {
+    }
+
+    ~aligned_buffer() noexcept { std::free(m_data); }
+
+    aligned_buffer(const aligned_buffer&)                    = delete;
+    auto operator=(const aligned_buffer&) -> aligned_buffer& = delete;
+
+    aligned_buffer(aligned_buffer&& other) noexcept
+        : m_size(std::exchange(other.m_size, 0)),
+          m_data(std::exchange(other.m_data, nullptr))
+    {
+    }
+
+    auto operator=(aligned_buffer&& other) noexcept -> aligned_buffer&
+    {
+        if (this != &other)
+        {
+            std::free(m_data);
+            m_size = std::exchange(other.m_size, 0);
+            m_data = std::exchange(other.m_data, nullptr);
+        }
+        return *this;
+    }
+
+    inline auto data() const noexcept -> char* { return m_data; }
+
+    inline auto size() const noexcept -> size_t { return m_size; }
+
+    // return false if allocation fails
+    inline explicit operator bool() const noexcept { return m_data != nullptr; }
+
+private:
+    size_t m_size{0};
+    char*  m_data{nullptr};
+};
+
+/**
+ * @brief file wraps a fd opened by fs::open(), all operations are io_uring requests
+ * and return negative errno on failure
+ *
+ * @note file doesn't close fd on destruction, co_await close() explicitly
+ */
+class file
+{
+public:
+    explicit file(int fd) noexcept : m_fd(fd) {}
+
+    inline auto fd() const noexcept -> int { return m_fd; }
+
+    read_awaiter read(void* buf, size_t len, uint64_t offset) noexcept
+    {
+        return read_awaiter(m_fd, buf, len, offset);
+    }
+
+    read_awaiter read(aligned_buffer& buf, uint64_t offset) noexcept
+    {
+        return read_awaiter(m_fd, buf.data(), buf.size(), offset);
+    }
+
+    write_awaiter write(const void* buf, size_t len, uint64_t offset) noexcept
+    {
+        return write_awaiter(m_fd, buf, len, offset);
+    }
+
+    write_awaiter write(const aligned_buffer& buf, uint64_t offset) noexcept
+    {
+        return write_awaiter(m_fd, buf.data(), buf.size(), offset);
+    }
+
+    /**
+     * @brief flush file, pass IORING_FSYNC_DATASYNC to flags for fdatasync
+     *
+     */
+    fsync_awaiter fsync(unsigned int flags = 0) noexcept { return fsync_awaiter(m_fd, flags); }
+
+    fallocate_awaiter fallocate(uint64_t offset, uint64_t len, int mode = 0) noexcept
+    {
+        return fallocate_awaiter(m_fd, mode, offset, len);
+    }
+
+    statx_awaiter stat(struct statx* buf, unsigned int mask = STATX_BASIC_STATS) noexcept
+    {
+        return statx_awaiter(m_fd, "", AT_EMPTY_PATH, mask, buf);
+    }
+
+    close_awaiter close() noexcept { return close_awaiter(m_fd); }
+
+private:
+    int m_fd;
+};
+
+/**
+ * @brief open file relative to current working directory, co_await returns fd or negative errno
+ *
+ * @note path must stay alive until co_await returns
+ */
+inline auto open(const char* path, int flags, mode_t mode = 0644) noexcept -> open_awaiter
+{
+    return open_awaiter(AT_FDCWD, path, flags, mode);
+}
+
+/**
+ * @brief get file status by path, co_await returns 0 or negative errno
+ *
+ */
+inline auto stat(const char* path, struct statx* buf, unsigned int mask = STATX_BASIC_STATS) noexcept -> statx_awaiter
+{
+    return statx_awaiter(AT_FDCWD, path, 0, mask, buf);
+}
+
+}; // namespace coro::fs
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "coro/net/base_awaiter.hpp"
+
+namespace coro::fs
+{
+using ::coro::net::detail::io_info;
+
+namespace detail
+{
+/**
+ * @brief base_fs_awaiter sets the io type and the callback shared by all file operations,
+ * which resumes coroutine with the cqe result
+ *
+ */
+class base_fs_awaiter : public net::detail::base_io_awaiter
+{
+public:
+    explicit base_fs_awaiter(net::detail::io_type type) noexcept;
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+};
+}; // namespace detail
+
+// the largest length a single read or write transfers, which is MAX_RW_COUNT of linux
+inline constexpr size_t kMaxRwCount = 0x7ffff000;
+
+class open_awaiter : public detail::base_fs_awaiter
+{
+public:
+    open_awaiter(int dfd, const char* path, int flags, mode_t mode) noexcept;
+};
+
+/**
+ * @brief read at most len bytes, len is clamped to kMaxRwCount because uring takes 32 bit length
+ * and result, so large read returns short like read(2)
+ *
+ */
+class read_awaiter : public detail::base_fs_awaiter
+{
+public:
+    read_awaiter(int fd, void* buf, size_t len, uint64_t offset) noexcept;
+};
+
+/**
+ * @brief write at most len bytes, len is clamped to kMaxRwCount like read_awaiter
+ *
+ */
+class write_awaiter : public detail::base_fs_awaiter
+{
+public:
+    write_awaiter(int fd, const void* buf, size_t len, uint64_t offset) noexcept;
+};
+
+class fsync_awaiter : public detail::base_fs_awaiter
+{
+public:
+    fsync_awaiter(int fd, unsigned int flags) noexcept;
+};
+
+class fallocate_awaiter : public detail::base_fs_awaiter
+{
+public:
+    fallocate_awaiter(int fd, int mode, uint64_t offset, uint64_t len) noexcept;
+};
+
+class statx_awaiter : public detail::base_fs_awaiter
+{
+public:
+    statx_awaiter(int dfd, const char* path, int flags, unsigned int mask, struct statx* buf) noexcept;
+};
+
+class close_awaiter : public detail::base_fs_awaiter
+{
+public:
+    explicit close_awaiter(int fd) noexcept;
+};
+
+}; // namespace coro::fs
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+namespace coro::http
+{
+/**
+ * @brief arena is a bump allocator for text owned by one connection, it is allocated once
+ * when connection is set up and reset after every response is sent
+ *
+ */
+class arena
+{
+public:
+    explicit arena(size_t size) noexcept : m_data(new char[size]), m_size(size) {}
+
+    arena(const arena&)                    = delete;
+    auto operator=(const arena&) -> arena& = delete;
+
+    /**
+     * @brief allocate n bytes
+     *
+     * @return char* nullptr if arena is exhausted
+     */
+    inline auto alloc(size_t n) noexcept -> char*
+    {
+        if (m_size - m_used < n)
+        {
+            return nullptr;
+        }
+        auto ptr = m_data.get() + m_used;
+        m_used += n;
+        return ptr;
+    }
+
+    /**
+     * @brief copy str into arena
+     *
+     * @return std::string_view nullptr data if arena is exhausted
+     */
+    inline auto copy(std::string_view str) noexcept -> std::string_view
+    {
+        auto ptr = alloc(str.size());
+        if (ptr == nullptr)
+        {
+            return std::string_view{};
+        }
+        memcpy(ptr, str.data(), str.size());
+        return std::string_view(ptr, str.size());
+    }
+
+    // address of the next allocation
+    inline auto top() const noexcept -> const char* { return m_data.get() + m_used; }
+
+    inline auto used() const noexcept -> size_t { return m_used; }
+
+    inline auto reset() noexcept -> void { m_used = 0; }
+
+private:
+    std::unique_ptr<char[]> m_data;
+    size_t                  m_size;
+    size_t                  m_used{0};
+};
+
+}; // namespace coro::http
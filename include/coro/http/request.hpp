@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "config.h"
+
+namespace coro::http
+{
+struct header
+{
+    std::string_view name;
+    std::string_view value;
+};
+
+/**
+ * @brief request parsed by parse_request(), all views point into the read buffer of connection
+ * and are valid only while the handler runs
+ *
+ */
+struct request
+{
+    std::string_view                                    method;
+    std::string_view                                    target;
+    int                                                 minor_version{1};
+    std::array<header, ::coro::config::kHttpMaxHeaders> header_buf;
+    size_t                                              header_cnt{0};
+    std::string_view                                    body;
+    uint64_t                                            content_length{0};
+    bool                                                chunked{false}; // Transfer-Encoding: chunked
+    bool                                                keep_alive{true};
+
+    inline auto headers() const noexcept -> std::span<const header>
+    {
+        return std::span<const header>(header_buf.data(), header_cnt);
+    }
+
+    /**
+     * @brief find header value by case-insensitive name
+     *
+     * @return std::string_view empty if header doesn't exist
+     */
+    auto find(std::string_view name) const noexcept -> std::string_view;
+};
+
+/**
+ * @brief parse request line and headers at the front of data, body is not touched
+ *
+ * @return int length of header block, 0 if data is incomplete, -1 if request is malformed
+ */
+auto parse_request(std::string_view data, request& req) noexcept -> int;
+
+namespace detail
+{
+// return position of the first c in [begin, end), nullptr if not found
+auto find_char(const char* begin, const char* end, char c) noexcept -> const char*;
+
+auto iequals(std::string_view lhs, std::string_view rhs) noexcept -> bool;
+}; // namespace detail
+
+}; // namespace coro::http
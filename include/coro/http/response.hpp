@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "coro/http/arena.hpp"
+#include "coro/http/request.hpp"
+
+namespace coro::http
+{
+/**
+ * @brief response is filled by handler and sent by server after handler returns,
+ * nothing is allocated from heap, copied text lives in the connection arena
+ *
+ * @note views passed to header() and body() are not copied, they must stay valid until
+ * handler returns, e.g. literals, views of request or text copied by arena().copy()
+ */
+class response
+{
+    friend class server;
+
+public:
+    static constexpr size_t kMaxHeaders = 16;
+    static constexpr size_t kMaxPieces  = 16;
+
+    /**
+     * @brief response to req, it takes keep-alive, http version and method of req
+     *
+     */
+    response(arena& ar, const request& req) noexcept
+        : m_arena(ar),
+          m_keep_alive(req.keep_alive),
+          m_http10(req.minor_version == 0),
+          m_head_only(req.method == "HEAD")
+    {
+    }
+
+    /**
+     * @brief set status code, code outside 100-999 is sent as 500
+     *
+     */
+    inline auto status(int code) noexcept -> response&
+    {
+        m_status = code;
+        return *this;
+    }
+
+    /**
+     * @brief add a header, Content-Length, Transfer-Encoding and Connection are set by server
+     *
+     * @return false if there are too many headers
+     */
+    auto header(std::string_view name, std::string_view value) noexcept -> bool;
+
+    /**
+     * @brief append data to body without copying
+     *
+     * @return false if body has too many pieces
+     */
+    auto body(std::string_view data) noexcept -> bool;
+
+    /**
+     * @brief copy data into arena and append it to body, in chunked mode every call produces one chunk
+     *
+     * @return false if arena is exhausted or body has too many pieces
+     */
+    auto write(std::string_view data) noexcept -> bool;
+
+    /**
+     * @brief send body with Transfer-Encoding: chunked instead of Content-Length
+     *
+     */
+    inline auto chunked() noexcept -> response&
+    {
+        m_chunked = true;
+        return *this;
+    }
+
+    /**
+     * @brief close connection after this response
+     *
+     */
+    inline auto close() noexcept -> response&
+    {
+        m_keep_alive = false;
+        return *this;
+    }
+
+    inline auto get_arena() noexcept -> arena& { return m_arena; }
+
+    inline auto keep_alive() const noexcept -> bool { return m_keep_alive; }
+
+    /**
+     * @brief response to HEAD request sends headers only, Content-Length still counts the body
+     *
+     */
+    inline auto head_only() const noexcept -> bool { return m_head_only; }
+
+private:
+    /**
+     * @brief format status line and headers into arena
+     *
+     * @return std::string_view nullptr data if arena is exhausted
+     */
+    auto build_head() noexcept -> std::string_view;
+
+private:
+    arena&                                   m_arena;
+    int                                      m_status{200};
+    std::array<http::header, kMaxHeaders>    m_headers;
+    size_t                                   m_header_cnt{0};
+    std::array<std::string_view, kMaxPieces> m_pieces;
+    size_t                                   m_piece_cnt{0};
+    bool                                     m_chunked{false};
+    bool                                     m_keep_alive;
+    bool                                     m_http10;
+    bool                                     m_head_only;
+};
+
+/**
+ * @brief reason phrase of status code, "Unknown" for codes not listed
+ *
+ */
+auto reason_phrase(int code) noexcept -> std::string_view;
+
+}; // namespace coro::http
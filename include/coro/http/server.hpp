@@ -0,0 +1,56 @@
+#pragma once
+
+#include <functional>
+
+#include "coro/http/arena.hpp"
+#include "coro/http/request.hpp"
+#include "coro/http/response.hpp"
+#include "coro/net/buffered_stream.hpp"
+#include "coro/net/tcp.hpp"
+#include "coro/task.hpp"
+
+namespace coro::http
+{
+/**
+ * @brief minimal http/1.1 server, it supports keep-alive, pipelined requests, requests with
+ * Content-Length body and chunked responses, requests with chunked body are rejected by 501
+ *
+ * @note responses of pipelined requests are coalesced and flushed before the connection waits for
+ * more data, so a batch of requests costs one read and one write
+ *
+ * @note handler runs on the context owning the connection and must not block, to spread connections
+ * over all contexts run serve() on every context with listen_options::reuse_port:
+ *
+ *     http::server srv([](const http::request& req, http::response& resp) { resp.body("hello"); });
+ *     scheduler::submit_to_each([&] { return srv.serve(nullptr, 8080, net::listen_options{.reuse_port = true}); });
+ */
+class server
+{
+public:
+    using handler = std::function<void(const request&, response&)>;
+
+    explicit server(handler h) noexcept : m_handler(std::move(h)) {}
+
+    /**
+     * @brief listen on addr:port and serve connections on current context, server must outlive it
+     *
+     */
+    auto serve(const char* addr, int port, net::listen_options opts = {}) -> task<>;
+
+    /**
+     * @brief serve one accepted connection until it closes, fd is closed at the end
+     *
+     * @note serve() runs it for every accepted connection, call it directly for sockets
+     * accepted elsewhere, e.g. unix domain sockets
+     */
+    auto session(int fd) -> task<>;
+
+private:
+    // write response into stream, return 0 or negative errno
+    static auto send(net::buffered_stream& stream, response& resp) -> task<int>;
+
+private:
+    handler m_handler;
+};
+
+}; // namespace coro::http
@@ -6,18 +6,29 @@
 #include "coro/net/io_info.hpp"
 #include "coro/uring_proxy.hpp"
 
+namespace coro::net
+{
+template<typename... awaiters>
+class io_link;
+
+template<typename awaiter_type>
+class guarded_awaiter;
+}; // namespace coro::net
+
 namespace coro::net::detail
 {
 
 class base_io_awaiter
 {
+    template<typename... awaiters>
+    friend class ::coro::net::io_link;
+
+    template<typename awaiter_type>
+    friend class ::coro::net::guarded_awaiter;
+
 public:
-    base_io_awaiter() noexcept : m_urs(coro::detail::local_engine().get_free_urs())
-    {
-        // TODO: you should no-block wait when get_free_urs return nullptr,
-        // this means io submit rate is too high.
-        assert(m_urs != nullptr && "io submit rate is too high");
-    }
+    // if uring is full, sqe is staged by engine and submitted later, coroutine just waits longer
+    base_io_awaiter() noexcept : m_urs(coro::detail::local_engine().get_sqe()) {}
 
     constexpr auto await_ready() noexcept -> bool { return false; }
 
@@ -26,6 +37,18 @@ public:
     auto await_resume() noexcept -> int32_t { return m_info.result; }
 
 protected:
+    // point sqe to the io_info again after the awaiter is moved, sqe isn't submitted until
+    // coroutine suspends, derived awaiter which sqe refers to its other members should hide this
+    inline auto relocate() noexcept -> void { io_uring_sqe_set_data(m_urs, &m_info); }
+
+    // io which fails before it is submitted still takes its sqe with a nop, so it completes in the
+    // usual way and callback gets err, io_link and guarded_awaiter see the error as well
+    inline auto prep_fail(int32_t err) noexcept -> void
+    {
+        io_uring_prep_nop(m_urs);
+        m_info.fail = err;
+    }
+
     io_info             m_info;
     coro::uring::ursptr m_urs;
 };
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+#include "config.h"
+#include "coro/net/tcp.hpp"
+#include "coro/task.hpp"
+
+namespace coro::net
+{
+/**
+ * @brief buffered_stream adds a read buffer and a write buffer to tcp_connector, one read fetches
+ * as much data as the buffer can hold, so a parser gets a batch of messages per read, and writes
+ * are coalesced until flush() or until config::kStreamFlushThreshold bytes are pending
+ *
+ * @note string_view returned by read_until(), read_exact(), peek() and buffered() points into
+ * the read buffer and stays valid until the next read_until(), read_exact() or peek()
+ *
+ * @note read buffer is linear, unread bytes are moved to the front or the buffer is doubled
+ * when it has no room at the tail, so every message is returned as one contiguous view
+ */
+class buffered_stream
+{
+public:
+    explicit buffered_stream(tcp_connector conn, size_t init_size = ::coro::config::kStreamBufInitSize) noexcept;
+
+    buffered_stream(const buffered_stream&)                    = delete;
+    auto operator=(const buffered_stream&) -> buffered_stream& = delete;
+
+    inline auto connector() noexcept -> tcp_connector& { return m_conn; }
+
+    /**
+     * @brief read until delim and consume the bytes
+     *
+     * @return task<std::string_view> data ending with delim, empty if stream ends before delim,
+     * see result()
+     */
+    auto read_until(std::string_view delim) -> task<std::string_view>;
+
+    /**
+     * @brief read exactly n bytes and consume them
+     *
+     * @return task<std::string_view> n bytes, empty if stream ends before n bytes arrive,
+     * see result()
+     */
+    auto read_exact(size_t n) -> task<std::string_view>;
+
+    /**
+     * @brief wait until at least n bytes are buffered without consuming them
+     *
+     * @return task<std::string_view> all buffered bytes, shorter than n if stream ends, see result()
+     */
+    auto peek(size_t n = 1) -> task<std::string_view>;
+
+    /**
+     * @brief bytes buffered but not consumed
+     *
+     */
+    inline auto buffered() const noexcept -> std::string_view
+    {
+        return std::string_view(m_rbuf.get() + m_rhead, m_rtail - m_rhead);
+    }
+
+    inline auto consume(size_t n) noexcept -> void
+    {
+        assert(n <= m_rtail - m_rhead && "consume more bytes than buffered");
+        m_rhead += n;
+        if (m_rhead == m_rtail)
+        {
+            m_rhead = m_rtail = 0;
+        }
+    }
+
+    /**
+     * @brief result of the last read, 0 means peer closed, negative errno means error,
+     * -ENOBUFS means a message is larger than config::kStreamBufMaxSize
+     *
+     */
+    inline auto result() const noexcept -> int { return m_result; }
+
+    /**
+     * @brief append data to write buffer, flush if pending bytes reach the threshold
+     *
+     * @return task<int> 0 or negative errno of flushing
+     */
+    auto write(std::string_view data) -> task<int>;
+
+    /**
+     * @brief send all pending bytes
+     *
+     * @return task<int> 0 or negative errno, unsent bytes stay in the buffer on error
+     */
+    auto flush() -> task<int>;
+
+    inline auto pending_write() const noexcept -> size_t { return m_wlen; }
+
+private:
+    // read once into the tail of read buffer, return the read result
+    auto fill() -> task<int>;
+
+    // make room for at least n unread bytes in total, return false if n exceeds the max size
+    auto reserve(size_t n) noexcept -> bool;
+
+private:
+    tcp_connector           m_conn;
+    std::unique_ptr<char[]> m_rbuf;
+    size_t                  m_rcap;
+    size_t                  m_rhead{0};
+    size_t                  m_rtail{0};
+    int                     m_result{1};
+    std::unique_ptr<char[]> m_wbuf;
+    size_t                  m_wcap{0};
+    size_t                  m_wlen{0};
+};
+
+}; // namespace coro::net
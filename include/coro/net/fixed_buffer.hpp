@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "coro/engine.hpp"
+#include "coro/uring_proxy.hpp"
+
+namespace coro::net
+{
+using ::coro::uring::uring_proxy;
+
+/**
+ * @brief fixed_buffer borrows one registered buffer from local engine's uring and gives it back
+ * when destroyed, read_fixed/write_fixed on it skip page pinning in kernel
+ *
+ * @note if local engine has no free registered buffer, fixed_buffer falls back to a heap buffer
+ * of the same size and io on it works as normal read/write
+ */
+class fixed_buffer
+{
+public:
+    fixed_buffer() noexcept : m_owner(&::coro::detail::local_engine().get_uring())
+    {
+        m_idx = m_owner->borrow_fixed_buffer();
+        if (m_idx >= 0)
+        {
+            m_data = m_owner->fixed_buffer_data(m_idx);
+        }
+        else
+        {
+            m_data = new char[config::kFixedBufferSize];
+        }
+    }
+
+    ~fixed_buffer() noexcept { release(); }
+
+    fixed_buffer(const fixed_buffer&)            = delete;
+    fixed_buffer& operator=(const fixed_buffer&) = delete;
+
+    fixed_buffer(fixed_buffer&& other) noexcept
+        : m_owner(other.m_owner),
+          m_idx(std::exchange(other.m_idx, -1)),
+          m_data(std::exchange(other.m_data, nullptr))
+    {
+    }
+
+    fixed_buffer& operator=(fixed_buffer&& other) noexcept
+    {
+        if (std::addressof(other) != this)
+        {
+            release();
+            m_owner = other.m_owner;
+            m_idx   = std::exchange(other.m_idx, -1);
+            m_data  = std::exchange(other.m_data, nullptr);
+        }
+        return *this;
+    }
+
+    inline auto data() noexcept -> char* { return m_data; }
+
+    inline auto size() const noexcept -> size_t { return config::kFixedBufferSize; }
+
+    inline auto index() const noexcept -> int { return m_idx; }
+
+    /**
+     * @brief return if buffer is registered in upxy, only then io can use its index
+     *
+     * @param upxy
+     * @return true
+     * @return false
+     */
+    inline auto registered_in(uring_proxy& upxy) const noexcept -> bool { return m_idx >= 0 && m_owner == &upxy; }
+
+private:
+    auto release() noexcept -> void
+    {
+        if (m_idx >= 0)
+        {
+            m_owner->return_fixed_buffer(m_idx);
+        }
+        else
+        {
+            delete[] m_data;
+        }
+        m_idx  = -1;
+        m_data = nullptr;
+    }
+
+private:
+    uring_proxy* m_owner;
+    int          m_idx{-1};
+    char*        m_data{nullptr};
+};
+
+}; // namespace coro::net
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <netdb.h>
+#include <span>
+#include <sys/socket.h>
+#include <sys/uio.h>
 
 #include "coro/net/base_awaiter.hpp"
+#include "coro/net/fixed_buffer.hpp"
 
 namespace coro::net
 {
@@ -42,6 +46,346 @@ public:
     static auto callback(io_info* data, int res) noexcept -> void;
 };
 
+class tcp_readv_awaiter : public detail::base_io_awaiter
+{
+public:
+    tcp_readv_awaiter(int sockfd, std::span<iovec> iov) noexcept;
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+};
+
+class tcp_writev_awaiter : public detail::base_io_awaiter
+{
+public:
+    tcp_writev_awaiter(int sockfd, std::span<const iovec> iov) noexcept;
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+};
+
+class tcp_recvmsg_awaiter : public detail::base_io_awaiter
+{
+public:
+    tcp_recvmsg_awaiter(int sockfd, std::span<iovec> iov, int flags) noexcept;
+    tcp_recvmsg_awaiter(int sockfd, msghdr* msg, int flags) noexcept;
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+
+private:
+    template<typename... awaiters>
+    friend class io_link;
+
+    template<typename awaiter_type>
+    friend class guarded_awaiter;
+
+    inline auto relocate() noexcept -> void
+    {
+        base_io_awaiter::relocate();
+        if (m_msg.msg_iov != nullptr)
+        {
+            m_urs->addr = reinterpret_cast<uint64_t>(&m_msg);
+        }
+    }
+
+    msghdr m_msg; // used when awaiter is built from iovec
+};
+
+class tcp_sendmsg_awaiter : public detail::base_io_awaiter
+{
+public:
+    tcp_sendmsg_awaiter(int sockfd, std::span<const iovec> iov, int flags) noexcept;
+    tcp_sendmsg_awaiter(int sockfd, const msghdr* msg, int flags) noexcept;
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+
+private:
+    template<typename... awaiters>
+    friend class io_link;
+
+    template<typename awaiter_type>
+    friend class guarded_awaiter;
+
+    inline auto relocate() noexcept -> void
+    {
+        base_io_awaiter::relocate();
+        if (m_msg.msg_iov != nullptr)
+        {
+            m_urs->addr = reinterpret_cast<uint64_t>(&m_msg);
+        }
+    }
+
+    msghdr m_msg; // used when awaiter is built from iovec
+};
+
+class udp_recvfrom_awaiter : public detail::base_io_awaiter
+{
+public:
+    udp_recvfrom_awaiter(int sockfd, char* buf, size_t len, sockaddr* from, socklen_t fromlen) noexcept;
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+
+private:
+    template<typename... awaiters>
+    friend class io_link;
+
+    template<typename awaiter_type>
+    friend class guarded_awaiter;
+
+    inline auto relocate() noexcept -> void
+    {
+        base_io_awaiter::relocate();
+        m_msg.msg_iov = &m_iov;
+        m_urs->addr   = reinterpret_cast<uint64_t>(&m_msg);
+    }
+
+    msghdr m_msg;
+    iovec  m_iov;
+};
+
+/**
+ * @brief send one datagram, the address is copied into awaiter, co_await returns -EINVAL if address is invalid
+ *
+ */
+class udp_sendto_awaiter : public detail::base_io_awaiter
+{
+public:
+    // address length is decided by the family of to, ipv4 and ipv6 are supported
+    udp_sendto_awaiter(int sockfd, const char* buf, size_t len, const sockaddr* to) noexcept;
+
+    udp_sendto_awaiter(int sockfd, const char* buf, size_t len, const char* addr, int port) noexcept;
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+
+private:
+    template<typename... awaiters>
+    friend class io_link;
+
+    template<typename awaiter_type>
+    friend class guarded_awaiter;
+
+    inline auto relocate() noexcept -> void
+    {
+        base_io_awaiter::relocate();
+        m_msg.msg_name = &m_to;
+        m_msg.msg_iov  = &m_iov;
+        m_urs->addr    = reinterpret_cast<uint64_t>(&m_msg);
+    }
+
+    auto prep_send(int sockfd, socklen_t tolen) noexcept -> void;
+
+    msghdr           m_msg;
+    iovec            m_iov;
+    sockaddr_storage m_to;
+};
+
+// max number of fds passed by one message
+constexpr size_t kMaxPassFds = 16;
+
+/**
+ * @brief send fds by SCM_RIGHTS, co_await returns -EINVAL if fds has more than kMaxPassFds fds
+ *
+ */
+class unix_send_fds_awaiter : public detail::base_io_awaiter
+{
+public:
+    unix_send_fds_awaiter(int sockfd, std::span<const int> fds, const char* buf, size_t len) noexcept;
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+
+private:
+    template<typename... awaiters>
+    friend class io_link;
+    template<typename awaiter_type>
+    friend class guarded_awaiter;
+
+    inline auto relocate() noexcept -> void
+    {
+        base_io_awaiter::relocate();
+        m_msg.msg_iov     = &m_iov;
+        m_msg.msg_control = m_ctrl;
+        m_urs->addr       = reinterpret_cast<uint64_t>(&m_msg);
+    }
+
+    msghdr m_msg;
+    iovec  m_iov;
+    char   m_ctrl[CMSG_SPACE(sizeof(int) * kMaxPassFds)];
+};
+
+class unix_recv_fds_awaiter : public detail::base_io_awaiter
+{
+public:
+    unix_recv_fds_awaiter(int sockfd, std::span<int> fds, char* buf, size_t len) noexcept;
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+
+private:
+    // io_link isn't a friend, it replaces m_info.cb and m_info.data with its own, but fds can only be
+    // parsed by the callback of this awaiter, io_link rejects this awaiter by static_assert
+    template<typename awaiter_type>
+    friend class guarded_awaiter;
+
+    inline auto relocate() noexcept -> void
+    {
+        base_io_awaiter::relocate();
+        m_info.data       = CASTPTR(this);
+        m_msg.msg_iov     = &m_iov;
+        m_msg.msg_control = m_ctrl;
+        m_urs->addr       = reinterpret_cast<uint64_t>(&m_msg);
+    }
+
+    msghdr         m_msg;
+    iovec          m_iov;
+    std::span<int> m_fds;
+    char           m_ctrl[CMSG_SPACE(sizeof(int) * kMaxPassFds)];
+};
+
+/**
+ * @brief read into fixed buffer, len is clamped to buf.size() so io never runs past the buffer
+ *
+ */
+class tcp_read_fixed_awaiter : public detail::base_io_awaiter
+{
+public:
+    tcp_read_fixed_awaiter(int sockfd, fixed_buffer& buf, size_t len) noexcept;
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+};
+
+/**
+ * @brief write from fixed buffer, len is clamped to buf.size() like tcp_read_fixed_awaiter
+ *
+ */
+class tcp_write_fixed_awaiter : public detail::base_io_awaiter
+{
+public:
+    tcp_write_fixed_awaiter(int sockfd, fixed_buffer& buf, size_t len) noexcept;
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+};
+
+/**
+ * @brief zc_tracker tracks the buffer of a zero copy send, kernel keeps referring to
+ * the buffer after the send returns, until the notification arrives
+ *
+ * @note one tracker serves one running zero copy send, wait() before reusing the buffer,
+ * sending again or destroying the tracker
+ */
+class zc_tracker
+{
+    friend class tcp_write_zc_awaiter;
+
+    struct release_awaiter
+    {
+        zc_tracker& tracker;
+
+        auto await_ready() noexcept -> bool { return !tracker.m_pending; }
+
+        auto await_suspend(std::coroutine_handle<> handle) noexcept -> void { tracker.m_waiter = handle; }
+
+        auto await_resume() noexcept -> void {}
+    };
+
+public:
+    zc_tracker() noexcept = default;
+    ~zc_tracker() noexcept { assert(!m_pending && "zero copy send is still referring to the buffer"); }
+
+    zc_tracker(const zc_tracker&)                    = delete;
+    zc_tracker(zc_tracker&&)                         = delete;
+    auto operator=(const zc_tracker&) -> zc_tracker& = delete;
+    auto operator=(zc_tracker&&) -> zc_tracker&      = delete;
+
+    /**
+     * @brief return if kernel still refers to the buffer
+     *
+     */
+    inline auto pending() const noexcept -> bool { return m_pending; }
+
+    /**
+     * @brief wait until kernel releases the buffer
+     *
+     */
+    inline auto wait() noexcept -> release_awaiter { return release_awaiter{*this}; }
+
+private:
+    io_info                 m_info;
+    bool                    m_pending{false};
+    std::coroutine_handle<> m_waiter{nullptr};
+};
+
+class tcp_write_zc_awaiter : public detail::base_io_awaiter
+{
+public:
+    tcp_write_zc_awaiter(int sockfd, char* buf, size_t len, int flags, zc_tracker& tracker) noexcept;
+
+    auto await_suspend(std::coroutine_handle<> handle) noexcept -> void { m_tracker.m_info.handle = handle; }
+
+    auto await_resume() noexcept -> int32_t { return m_tracker.m_info.result; }
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+
+private:
+    zc_tracker& m_tracker;
+};
+
+class splice_awaiter : public detail::base_io_awaiter
+{
+public:
+    splice_awaiter(int fd_in, int64_t off_in, int fd_out, int64_t off_out, unsigned int len, unsigned int flags) noexcept;
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+};
+
+/**
+ * @brief send_file_awaiter moves file data to socket by splice without copying through user space,
+ * each round links splice(file -> pipe) and splice(pipe -> socket) with IOSQE_IO_LINK, the next round
+ * is submitted from cqe callback, so coroutine resumes only once
+ *
+ * @note co_await returns number of bytes sent, or negative errno if nothing is sent
+ */
+class send_file_awaiter
+{
+public:
+    send_file_awaiter(int sockfd, int fd, uint64_t offset, size_t len) noexcept;
+
+    send_file_awaiter(const send_file_awaiter&)                    = delete;
+    send_file_awaiter(send_file_awaiter&&)                         = delete;
+    auto operator=(const send_file_awaiter&) -> send_file_awaiter& = delete;
+    auto operator=(send_file_awaiter&&) -> send_file_awaiter&      = delete;
+
+    auto await_ready() noexcept -> bool { return m_done; }
+
+    auto await_suspend(std::coroutine_handle<> handle) noexcept -> void { m_handle = handle; }
+
+    auto await_resume() noexcept -> int64_t { return m_result; }
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+
+private:
+    // submit next round, only the pipe -> socket step if pipe still holds data
+    auto submit_round() noexcept -> void;
+
+    auto finish_round() noexcept -> void;
+
+    auto finish(int64_t result) noexcept -> void;
+
+private:
+    io_info                 m_in_info;
+    io_info                 m_out_info;
+    std::coroutine_handle<> m_handle;
+    int                     m_sockfd;
+    int                     m_fd;
+    int                     m_pipe[2];
+    uint64_t                m_offset;
+    size_t                  m_remain;
+    size_t                  m_piped{0}; // bytes left in pipe
+    int64_t                 m_sent{0};
+    int64_t                 m_result{0};
+    int32_t                 m_in_res{0};
+    int32_t                 m_out_res{0};
+    int32_t                 m_wait{0};
+    bool                    m_in_submitted{false};
+    bool                    m_done{false};
+};
+
 class tcp_close_awaiter : public detail::base_io_awaiter
 {
 public:
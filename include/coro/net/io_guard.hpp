@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cerrno>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "coro/net/io_awaiter.hpp"
+
+namespace coro::net
+{
+class cancel_token;
+
+namespace detail
+{
+/**
+ * @brief io_guard redirects the cqe entry of an io awaiter to itself, so a linked timeout
+ * and a cancel request can be attached, the awaiter's own callback runs after all cqe entries
+ * of the io, the timeout and the cancel request arrive
+ */
+class io_guard
+{
+    friend class ::coro::net::cancel_token;
+
+protected:
+    using finish_func = void (*)(io_guard*, int32_t);
+
+    explicit io_guard(finish_func finish) noexcept;
+
+    io_guard(const io_guard&)                    = delete;
+    io_guard(io_guard&&)                         = delete;
+    auto operator=(const io_guard&) -> io_guard& = delete;
+    auto operator=(io_guard&&) -> io_guard&      = delete;
+
+    /**
+     * @brief take over the sqe of io, must be called right after the sqe is prepared,
+     * because the linked timeout sqe must follow it
+     *
+     * @param sqe sqe of io
+     * @param timeout zero means no timeout
+     * @param token nullptr means no cancel token
+     */
+    auto prepare(coro::uring::ursptr sqe, std::chrono::nanoseconds timeout, cancel_token* token) noexcept -> void;
+
+    // submit cancel request for the running io
+    auto cancel() noexcept -> void;
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+
+private:
+    io_info           m_io_info;
+    io_info           m_timeout_info;
+    io_info           m_cancel_info;
+    __kernel_timespec m_ts;
+    finish_func       m_finish;
+    cancel_token*     m_token{nullptr};
+    int32_t           m_res{0};
+    int32_t           m_remain{1}; // number of cqe entries to wait
+    bool              m_timed_out{false};
+};
+}; // namespace detail
+
+/**
+ * @brief cancel_token cancels the io it is bound to by io_uring_prep_cancel, the io returns -ECANCELED,
+ * io bound to a cancelled token completes with -ECANCELED immediately
+ *
+ * @note cancel() must be called on the context running the io, token must outlive the io
+ */
+class cancel_token
+{
+    friend class detail::io_guard;
+
+public:
+    cancel_token() noexcept = default;
+
+    cancel_token(const cancel_token&)                    = delete;
+    auto operator=(const cancel_token&) -> cancel_token& = delete;
+
+    /**
+     * @brief cancel the running io and all later io bound to this token
+     *
+     */
+    auto cancel() noexcept -> void
+    {
+        m_cancelled = true;
+        if (auto guard = std::exchange(m_running, nullptr); guard != nullptr)
+        {
+            guard->cancel();
+        }
+    }
+
+    inline auto cancelled() const noexcept -> bool { return m_cancelled; }
+
+    /**
+     * @brief make token usable again
+     *
+     */
+    inline auto reset() noexcept -> void { m_cancelled = false; }
+
+private:
+    detail::io_guard* m_running{nullptr};
+    bool              m_cancelled{false};
+};
+
+/**
+ * @brief guarded_awaiter wraps an io awaiter with optional timeout and cancel token,
+ * io that times out returns -ETIME, io that is cancelled returns -ECANCELED
+ *
+ * @note the wrapped awaiter must be built in the same expression, see with_timeout()
+ */
+template<typename awaiter_type>
+class guarded_awaiter : public detail::io_guard
+{
+    static_assert(std::is_base_of_v<detail::base_io_awaiter, awaiter_type>, "only io awaiter can be guarded");
+    static_assert(!std::is_same_v<awaiter_type, tcp_write_zc_awaiter>, "zero copy send can't be guarded");
+
+public:
+    guarded_awaiter(awaiter_type awaiter, std::chrono::nanoseconds timeout, cancel_token* token) noexcept
+        : io_guard(&guarded_awaiter::finish),
+          m_awaiter(std::move(awaiter))
+    {
+        // awaiter is moved, sqe must point to its new members before io_guard takes over sqe
+        m_awaiter.relocate();
+        prepare(m_awaiter.m_urs, timeout, token);
+    }
+
+    auto await_ready() noexcept -> bool { return m_awaiter.await_ready(); }
+
+    auto await_suspend(std::coroutine_handle<> handle) noexcept -> void { m_awaiter.await_suspend(handle); }
+
+    auto await_resume() noexcept -> decltype(auto) { return m_awaiter.await_resume(); }
+
+private:
+    static auto finish(io_guard* guard, int32_t res) noexcept -> void
+    {
+        auto& info = static_cast<guarded_awaiter*>(guard)->m_awaiter.m_info;
+        info.cb(&info, info.fail != 0 ? info.fail : res);
+    }
+
+    awaiter_type m_awaiter;
+};
+
+/**
+ * @brief bound io by timeout, implemented by IORING_OP_LINK_TIMEOUT
+ *
+ *     auto ret = co_await net::with_timeout(conn.read(buf, len), std::chrono::seconds(5));
+ */
+template<typename awaiter_type>
+inline auto with_timeout(awaiter_type awaiter, std::chrono::nanoseconds timeout) noexcept
+    -> guarded_awaiter<awaiter_type>
+{
+    return guarded_awaiter<awaiter_type>(std::move(awaiter), timeout, nullptr);
+}
+
+/**
+ * @brief bind io to cancel token
+ *
+ */
+template<typename awaiter_type>
+inline auto with_cancel(awaiter_type awaiter, cancel_token& token) noexcept -> guarded_awaiter<awaiter_type>
+{
+    return guarded_awaiter<awaiter_type>(std::move(awaiter), std::chrono::nanoseconds::zero(), &token);
+}
+
+/**
+ * @brief bound io by timeout and bind it to cancel token
+ *
+ */
+template<typename awaiter_type>
+inline auto with_timeout(awaiter_type awaiter, std::chrono::nanoseconds timeout, cancel_token& token) noexcept
+    -> guarded_awaiter<awaiter_type>
+{
+    return guarded_awaiter<awaiter_type>(std::move(awaiter), timeout, &token);
+}
+
+}; // namespace coro::net
@@ -23,6 +23,13 @@ enum io_type
     tcp_write,
     tcp_close,
     stdin,
+    file_open,
+    file_read,
+    file_write,
+    file_sync,
+    file_alloc,
+    file_stat,
+    file_close,
     none
 };
 
@@ -33,6 +40,8 @@ struct io_info
     io_type            type;
     uintptr_t          data;
     cb_type            cb;
+    uint32_t           flags;   // cqe flags, set before cb is called
+    int32_t            fail{0}; // error found before submitting, cb gets it instead of the result of io
 };
 
 inline uintptr_t ioinfo_to_ptr(io_info* info) noexcept
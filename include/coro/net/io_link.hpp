@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+#include "coro/net/io_awaiter.hpp"
+
+namespace coro::net
+{
+/**
+ * @brief link_timeout_awaiter bounds the step before it in an io_link, the step is
+ * cancelled with -ECANCELED if it doesn't complete in time
+ *
+ * @note only meaningful inside io_link, its own result is -ETIME if the timeout fires
+ */
+class link_timeout_awaiter : public detail::base_io_awaiter
+{
+    template<typename... awaiters>
+    friend class io_link;
+
+public:
+    explicit link_timeout_awaiter(std::chrono::nanoseconds timeout) noexcept;
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+
+private:
+    auto relocate() noexcept -> void
+    {
+        base_io_awaiter::relocate();
+        m_urs->addr = reinterpret_cast<uint64_t>(&m_ts);
+    }
+
+    __kernel_timespec m_ts;
+};
+
+inline auto link_timeout(std::chrono::nanoseconds timeout) noexcept -> link_timeout_awaiter
+{
+    return link_timeout_awaiter(timeout);
+}
+
+/**
+ * @brief io_link chains the sqes of awaiters with IOSQE_IO_LINK, kernel runs them in order and
+ * the coroutine resumes once after all steps complete, co_await returns the result of each step
+ *
+ * @note must be built with braces so awaiters are constructed from left to right,
+ * which is the order of their sqes:
+ *
+ *     auto [r1, r2, r3] = co_await net::io_link{conn.read(buf, len), conn.write(buf, len), conn.close()};
+ *
+ * @note if uring becomes full in the middle of building the chain, engine stages the whole chain and
+ * submits it once uring has room for all steps, chain can't be longer than the uring
+ *
+ * @note a failed step cancels the rest steps, they complete with -ECANCELED, results of steps are
+ * the raw cqe results, e.g. the result of connect step is 0 rather than fd
+ */
+template<typename... awaiters>
+class io_link
+{
+    static_assert(sizeof...(awaiters) > 0, "io_link needs at least one step");
+    static_assert(
+        (std::is_base_of_v<detail::base_io_awaiter, awaiters> && ...), "io_link step must be an io awaiter");
+    static_assert(
+        (!std::is_same_v<awaiters, tcp_write_zc_awaiter> && ...), "zero copy send can't be a io_link step");
+    static_assert((!std::is_same_v<awaiters, unix_recv_fds_awaiter> && ...),
+                  "receiving fds needs its own callback, it can't be a io_link step");
+
+public:
+    io_link(awaiters... steps) noexcept : m_steps(std::move(steps)...)
+    {
+        std::apply([this](auto&... step) { (prepare_step(step), ...); }, m_steps);
+        // every sqe except the last one links to the next sqe
+        std::apply([](auto&... step) { ((step.m_urs->flags |= IOSQE_IO_LINK), ...); }, m_steps);
+        std::get<sizeof...(awaiters) - 1>(m_steps).m_urs->flags &= ~IOSQE_IO_LINK;
+
+        std::apply(
+            [](auto&... step)
+            {
+                coro::uring::ursptr chain[] = {step.m_urs...};
+                coro::detail::local_engine().seal_chain(chain);
+            },
+            m_steps);
+    }
+
+    io_link(const io_link&)                    = delete;
+    io_link(io_link&&)                         = delete;
+    auto operator=(const io_link&) -> io_link& = delete;
+    auto operator=(io_link&&) -> io_link&      = delete;
+
+    constexpr auto await_ready() noexcept -> bool { return false; }
+
+    auto await_suspend(std::coroutine_handle<> handle) noexcept -> void { m_handle = handle; }
+
+    auto await_resume() noexcept -> std::array<int32_t, sizeof...(awaiters)>
+    {
+        return std::apply([](auto&... step) { return std::array<int32_t, sizeof...(awaiters)>{step.m_info.result...}; },
+                          m_steps);
+    }
+
+private:
+    template<typename awaiter_type>
+    auto prepare_step(awaiter_type& step) noexcept -> void
+    {
+        // awaiter is moved into io_link, so sqe must point to the new io_info
+        step.relocate();
+        step.m_info.cb   = &io_link::callback;
+        step.m_info.data = CASTPTR(this);
+    }
+
+    static auto callback(io_info* data, int res) noexcept -> void
+    {
+        data->result = res;
+        auto link    = reinterpret_cast<io_link*>(data->data);
+        if (--link->m_remain == 0)
+        {
+            submit_to_context(link->m_handle);
+        }
+    }
+
+private:
+    std::tuple<awaiters...> m_steps;
+    size_t                  m_remain{sizeof...(awaiters)};
+    std::coroutine_handle<> m_handle;
+};
+
+}; // namespace coro::net
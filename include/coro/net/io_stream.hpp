@@ -0,0 +1,496 @@
+#pragma once
+
+#include <cassert>
+#include <cerrno>
+#include <coroutine>
+#include <cstdint>
+#include <span>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "coro/context.hpp"
+#include "coro/net/io_info.hpp"
+#include "coro/uring_proxy.hpp"
+
+namespace coro::net
+{
+using ::coro::net::detail::io_info;
+
+namespace detail
+{
+/**
+ * @brief result of one cqe entry produced by multishot io
+ *
+ */
+struct stream_entry
+{
+    int32_t  res;
+    uint32_t flags;
+};
+
+/**
+ * @brief base_io_stream drives one multishot io, every cqe entry is queued until
+ * coroutine fetches it by co_await next()
+ *
+ * @tparam derived must implement arm() -> int, which prepares and submits the multishot sqe,
+ * return 0 if success or negative errno to end the stream, rearmable(res) -> bool, which
+ * tells if the stream can be armed again after the last cqe entry with result res, and
+ * discard(entry) -> void, which releases what an entry dropped by cancel() holds
+ *
+ * @note stream must be consumed until it yields the ending entry or be cancelled by co_await cancel()
+ * before destruction, because the running multishot io refers to the stream
+ */
+template<typename derived>
+class base_io_stream
+{
+public:
+    base_io_stream() noexcept
+    {
+        m_info.handle = nullptr;
+        m_info.cb     = &base_io_stream::callback;
+        m_info.data   = CASTPTR(this);
+
+        m_cancel_info.type = io_type::none;
+        m_cancel_info.cb   = &base_io_stream::cancel_callback;
+        m_cancel_info.data = CASTPTR(this);
+    }
+
+    ~base_io_stream() noexcept { assert(!m_armed && "io stream is destroyed while multishot io is running"); }
+
+    base_io_stream(const base_io_stream&)                    = delete;
+    base_io_stream(base_io_stream&&)                         = delete;
+    auto operator=(const base_io_stream&) -> base_io_stream& = delete;
+    auto operator=(base_io_stream&&) -> base_io_stream&      = delete;
+
+    /**
+     * @brief return if stream has yielded the ending entry
+     *
+     */
+    inline auto finished() const noexcept -> bool { return m_finished && m_head == m_entries.size(); }
+
+    struct cancel_awaiter
+    {
+        base_io_stream& stream;
+
+        auto await_ready() noexcept -> bool { return !stream.start_cancel(); }
+
+        auto await_suspend(std::coroutine_handle<> handle) noexcept -> void { stream.m_info.handle = handle; }
+
+        constexpr auto await_resume() noexcept -> void {}
+    };
+
+    /**
+     * @brief stop the running multishot io and wait for its last cqe entry, entries not fetched
+     * are dropped, then the stream yields -ECANCELED
+     *
+     * @note must be awaited on the context running the stream, and not while next() is awaited
+     *
+     * @return cancel_awaiter
+     */
+    inline auto cancel() noexcept -> cancel_awaiter { return cancel_awaiter{*this}; }
+
+protected:
+    struct entry_awaiter
+    {
+        base_io_stream& stream;
+
+        auto await_ready() noexcept -> bool { return stream.prepare(); }
+
+        auto await_suspend(std::coroutine_handle<> handle) noexcept -> void { stream.m_info.handle = handle; }
+
+        auto await_resume() noexcept -> stream_entry { return stream.pop(); }
+    };
+
+    inline auto next_entry() noexcept -> entry_awaiter { return entry_awaiter{*this}; }
+
+    // number of entries arrived but not fetched
+    inline auto pending() const noexcept -> size_t { return m_entries.size() - m_head; }
+
+    // submit multishot io, called by derived::arm()
+    auto submit(coro::uring::ursptr sqe) noexcept -> void
+    {
+        io_uring_sqe_set_data(sqe, &m_info);
+        coro::detail::local_engine().add_io_submit();
+        m_armed = true;
+    }
+
+    io_info m_info;
+
+    // return true if there is an entry to pop, otherwise arm the io if needed
+    auto prepare() noexcept -> bool
+    {
+        if (m_head < m_entries.size() || m_finished)
+        {
+            return true;
+        }
+        if (!m_armed)
+        {
+            if (auto ret = static_cast<derived*>(this)->arm(); ret < 0)
+            {
+                push(stream_entry{ret, 0});
+                m_finished = true;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto pop() noexcept -> stream_entry
+    {
+        if (m_head == m_entries.size())
+        {
+            // stream has finished, keep yielding the ending entry
+            return m_last;
+        }
+        auto entry = m_entries[m_head++];
+        if (m_head == m_entries.size())
+        {
+            m_entries.clear();
+            m_head = 0;
+        }
+        return entry;
+    }
+
+private:
+    inline auto push(stream_entry entry) noexcept -> void
+    {
+        m_entries.push_back(entry);
+        m_last = entry;
+    }
+
+    // return true if cancel request is submitted, otherwise stream is finished at once
+    auto start_cancel() noexcept -> bool
+    {
+        if (!m_armed)
+        {
+            finish_cancel();
+            return false;
+        }
+
+        auto sqe = coro::detail::local_engine().get_sqe();
+        io_uring_prep_cancel(sqe, &m_info, 0);
+        io_uring_sqe_set_data(sqe, &m_cancel_info);
+        coro::detail::local_engine().add_io_submit();
+
+        // wait for the cqe entry of cancel request and the last cqe entry of multishot io
+        m_cancel_remain = 2;
+        return true;
+    }
+
+    auto finish_cancel() noexcept -> void
+    {
+        for (; m_head < m_entries.size(); m_head++)
+        {
+            static_cast<derived*>(this)->discard(m_entries[m_head]);
+        }
+        m_entries.clear();
+        m_head     = 0;
+        m_last     = stream_entry{-ECANCELED, 0};
+        m_finished = true;
+    }
+
+    inline auto cancel_done() noexcept -> void
+    {
+        if (--m_cancel_remain == 0)
+        {
+            finish_cancel();
+            submit_to_context(std::exchange(m_info.handle, nullptr));
+        }
+    }
+
+    static auto callback(io_info* data, int res) noexcept -> void
+    {
+        auto stream = reinterpret_cast<base_io_stream*>(data->data);
+        if (stream->m_cancel_remain > 0)
+        {
+            static_cast<derived*>(stream)->discard(stream_entry{res, data->flags});
+            if (!(data->flags & IORING_CQE_F_MORE))
+            {
+                stream->m_armed = false;
+                stream->cancel_done();
+            }
+            return;
+        }
+
+        stream->push(stream_entry{res, data->flags});
+        if (!(data->flags & IORING_CQE_F_MORE))
+        {
+            stream->m_armed    = false;
+            stream->m_finished = !derived::rearmable(res);
+        }
+
+        if (auto handle = data->handle; handle != nullptr)
+        {
+            data->handle = nullptr;
+            submit_to_context(handle);
+        }
+    }
+
+    static auto cancel_callback(io_info* data, [[CORO_MAYBE_UNUSED]] int res) noexcept -> void
+    {
+        // -ENOENT or -EALREADY means the last cqe entry is on its way anyway
+        reinterpret_cast<base_io_stream*>(data->data)->cancel_done();
+    }
+
+private:
+    std::vector<stream_entry> m_entries;
+    size_t                    m_head{0};
+    stream_entry              m_last{0, 0};
+    bool                      m_armed{false};
+    bool                      m_finished{false};
+    io_info                   m_cancel_info;
+    int                       m_cancel_remain{0}; // cqe entries to wait before cancel() resumes
+};
+}; // namespace detail
+
+/**
+ * @brief recv_buffer is a view of the buffer selected by kernel from buffer ring,
+ * the buffer is given back to buffer ring when recv_buffer is destroyed
+ *
+ * @note result() < 0 means error, result() == 0 means peer closed
+ */
+class recv_buffer
+{
+public:
+    recv_buffer() noexcept = default;
+    recv_buffer(coro::uring::uring_proxy* upxy, detail::stream_entry entry) noexcept;
+    ~recv_buffer() noexcept { release(); }
+
+    recv_buffer(const recv_buffer&)                    = delete;
+    auto operator=(const recv_buffer&) -> recv_buffer& = delete;
+
+    recv_buffer(recv_buffer&& other) noexcept { *this = std::move(other); }
+    auto operator=(recv_buffer&& other) noexcept -> recv_buffer&;
+
+    inline auto data() const noexcept -> char* { return m_data; }
+
+    inline auto size() const noexcept -> size_t { return m_res > 0 ? static_cast<size_t>(m_res) : 0; }
+
+    inline auto result() const noexcept -> int32_t { return m_res; }
+
+    /**
+     * @brief give the buffer back to buffer ring before destruction
+     *
+     */
+    auto release() noexcept -> void;
+
+private:
+    coro::uring::uring_proxy* m_upxy{nullptr};
+    char*                     m_data{nullptr};
+    int32_t                   m_res{0};
+    int32_t                   m_bid{-1};
+};
+
+/**
+ * @brief tcp_recv_stream keeps a multishot recv running on sockfd, every recv selects
+ * a buffer from the buffer ring of current engine, so no buffer is pinned by idle connections
+ *
+ * @note -ENOBUFS means buffer ring is exhausted, release recv_buffer and call next() again,
+ * entry with result <= 0 except -ENOBUFS ends the stream
+ */
+class tcp_recv_stream : public detail::base_io_stream<tcp_recv_stream>
+{
+    friend class detail::base_io_stream<tcp_recv_stream>;
+
+    struct buffer_awaiter : entry_awaiter
+    {
+        auto await_resume() noexcept -> recv_buffer
+        {
+            auto& self = static_cast<tcp_recv_stream&>(stream);
+            return recv_buffer(self.m_upxy, entry_awaiter::await_resume());
+        }
+    };
+
+public:
+    explicit tcp_recv_stream(int sockfd) noexcept : m_sockfd(sockfd) { m_info.type = detail::io_type::tcp_read; }
+
+    /**
+     * @brief fetch next received buffer
+     *
+     * @return recv_buffer
+     */
+    inline auto next() noexcept -> buffer_awaiter { return buffer_awaiter{next_entry()}; }
+
+private:
+    auto arm() noexcept -> int;
+
+    static inline auto rearmable(int res) noexcept -> bool { return res > 0 || res == -ENOBUFS; }
+
+    inline auto discard(detail::stream_entry entry) noexcept -> void
+    {
+        // buffer of the entry goes back to buffer ring once buf is destroyed
+        recv_buffer buf(m_upxy, entry);
+    }
+
+private:
+    int                       m_sockfd;
+    coro::uring::uring_proxy* m_upxy{nullptr};
+};
+
+/**
+ * @brief udp_datagram is a datagram received by udp_recv_stream, it owns the buffer
+ * selected from buffer ring like recv_buffer
+ *
+ * @note datagram larger than config::kBufRingBufSize is truncated, see truncated()
+ */
+class udp_datagram
+{
+public:
+    udp_datagram() noexcept = default;
+    udp_datagram(coro::uring::uring_proxy* upxy, detail::stream_entry entry, msghdr* msg) noexcept;
+
+    inline auto data() const noexcept -> char* { return m_data; }
+
+    inline auto size() const noexcept -> size_t { return m_size; }
+
+    // negative errno if receiving fails
+    inline auto result() const noexcept -> int32_t { return m_buf.result(); }
+
+    // address of sender, nullptr if receiving fails
+    inline auto from() const noexcept -> const sockaddr* { return m_from; }
+
+    inline auto truncated() const noexcept -> bool { return m_truncated; }
+
+private:
+    recv_buffer     m_buf;
+    char*           m_data{nullptr};
+    size_t          m_size{0};
+    const sockaddr* m_from{nullptr};
+    bool            m_truncated{false};
+};
+
+/**
+ * @brief udp_recv_stream keeps a multishot recvmsg running on sockfd, datagrams are received into
+ * buffers of buffer ring and fetched one by one or in batch
+ *
+ * @note -ENOBUFS means buffer ring is exhausted, release datagrams and fetch again,
+ * entry with negative result except -ENOBUFS ends the stream
+ */
+class udp_recv_stream : public detail::base_io_stream<udp_recv_stream>
+{
+    friend class detail::base_io_stream<udp_recv_stream>;
+
+    struct datagram_awaiter : entry_awaiter
+    {
+        auto await_resume() noexcept -> udp_datagram
+        {
+            auto& self = static_cast<udp_recv_stream&>(stream);
+            return udp_datagram(self.m_upxy, self.pop(), &self.m_msg);
+        }
+    };
+
+    struct batch_awaiter : entry_awaiter
+    {
+        std::span<udp_datagram> out;
+
+        // fill out with datagrams arrived, at least one
+        auto await_resume() noexcept -> size_t
+        {
+            auto&  self = static_cast<udp_recv_stream&>(stream);
+            size_t num  = 0;
+            do
+            {
+                out[num++] = udp_datagram(self.m_upxy, self.pop(), &self.m_msg);
+            } while (num < out.size() && self.pending() > 0);
+            return num;
+        }
+    };
+
+public:
+    explicit udp_recv_stream(int sockfd) noexcept : m_sockfd(sockfd), m_msg{}
+    {
+        m_info.type       = detail::io_type::tcp_read;
+        m_msg.msg_namelen = sizeof(sockaddr_storage);
+    }
+
+    /**
+     * @brief fetch next datagram
+     *
+     * @return udp_datagram
+     */
+    inline auto next() noexcept -> datagram_awaiter { return datagram_awaiter{next_entry()}; }
+
+    /**
+     * @brief wait until some datagrams arrive and move them into out
+     *
+     * @param out must not be empty
+     * @return size_t number of datagrams filled
+     */
+    inline auto next_batch(std::span<udp_datagram> out) noexcept -> batch_awaiter
+    {
+        return batch_awaiter{next_entry(), out};
+    }
+
+private:
+    auto arm() noexcept -> int;
+
+    static inline auto rearmable(int res) noexcept -> bool { return res >= 0 || res == -ENOBUFS; }
+
+    inline auto discard(detail::stream_entry entry) noexcept -> void
+    {
+        // buffer of the entry goes back to buffer ring once buf is destroyed
+        recv_buffer buf(m_upxy, entry);
+    }
+
+private:
+    int                       m_sockfd;
+    msghdr                    m_msg; // layout of name and payload in buffer, kernel reads it on every receive
+    coro::uring::uring_proxy* m_upxy{nullptr};
+};
+
+/**
+ * @brief tcp_accept_stream keeps a multishot accept running on listenfd,
+ * next() yields the fd of new connection, one sqe serves all connections until
+ * kernel ends the multishot accept, then the stream re-arms
+ *
+ * @note transient errors such as -EMFILE are yielded and the stream goes on,
+ * other errors end the stream
+ */
+class tcp_accept_stream : public detail::base_io_stream<tcp_accept_stream>
+{
+    friend class detail::base_io_stream<tcp_accept_stream>;
+
+    struct fd_awaiter : entry_awaiter
+    {
+        auto await_resume() noexcept -> int { return entry_awaiter::await_resume().res; }
+    };
+
+public:
+    tcp_accept_stream(int listenfd, int flags) noexcept : m_listenfd(listenfd), m_flags(flags)
+    {
+        m_info.type = detail::io_type::tcp_accept;
+    }
+
+    /**
+     * @brief fetch next accepted connection
+     *
+     * @return int fd of connection or negative errno
+     */
+    inline auto next() noexcept -> fd_awaiter { return fd_awaiter{next_entry()}; }
+
+private:
+    auto arm() noexcept -> int;
+
+    static inline auto rearmable(int res) noexcept -> bool
+    {
+        return res >= 0 || res == -EMFILE || res == -ENFILE || res == -ENOBUFS || res == -ENOMEM ||
+               res == -ECONNABORTED || res == -EINTR;
+    }
+
+    // connection accepted but never fetched is closed
+    static inline auto discard(detail::stream_entry entry) noexcept -> void
+    {
+        if (entry.res >= 0)
+        {
+            ::close(entry.res);
+        }
+    }
+
+private:
+    int m_listenfd;
+    int m_flags;
+};
+
+}; // namespace coro::net
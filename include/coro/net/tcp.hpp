@@ -11,6 +11,7 @@
 
 #include "config.h"
 #include "coro/net/io_awaiter.hpp"
+#include "coro/net/io_stream.hpp"
 
 namespace coro::net
 {
@@ -20,6 +21,8 @@ class tcp_connector
 public:
     explicit tcp_connector(int sockfd) noexcept : m_sockfd(sockfd) {}
 
+    inline auto fd() const noexcept -> int { return m_sockfd; }
+
     tcp_read_awaiter read(char* buf, size_t len, int flags = 0) noexcept
     {
         return tcp_read_awaiter(m_sockfd, buf, len, flags);
@@ -30,37 +33,148 @@ public:
         return tcp_write_awaiter(m_sockfd, buf, len, flags);
     }
 
+    /**
+     * @brief scatter read into iov, iov must stay alive until the read returns
+     *
+     */
+    tcp_readv_awaiter readv(std::span<iovec> iov) noexcept { return tcp_readv_awaiter(m_sockfd, iov); }
+
+    /**
+     * @brief gather write from iov, iov must stay alive until the write returns
+     *
+     */
+    tcp_writev_awaiter writev(std::span<const iovec> iov) noexcept { return tcp_writev_awaiter(m_sockfd, iov); }
+
+    tcp_recvmsg_awaiter recvmsg(std::span<iovec> iov, int flags = 0) noexcept
+    {
+        return tcp_recvmsg_awaiter(m_sockfd, iov, flags);
+    }
+
+    tcp_recvmsg_awaiter recvmsg(msghdr* msg, int flags = 0) noexcept
+    {
+        return tcp_recvmsg_awaiter(m_sockfd, msg, flags);
+    }
+
+    tcp_sendmsg_awaiter sendmsg(std::span<const iovec> iov, int flags = 0) noexcept
+    {
+        return tcp_sendmsg_awaiter(m_sockfd, iov, flags);
+    }
+
+    tcp_sendmsg_awaiter sendmsg(const msghdr* msg, int flags = 0) noexcept
+    {
+        return tcp_sendmsg_awaiter(m_sockfd, msg, flags);
+    }
+
+    /**
+     * @brief zero copy write, coroutine resumes when the send completes, but buf
+     * can't be reused until tracker.wait() returns
+     *
+     */
+    tcp_write_zc_awaiter write_zc(char* buf, size_t len, zc_tracker& tracker, int flags = 0) noexcept
+    {
+        return tcp_write_zc_awaiter(m_sockfd, buf, len, flags, tracker);
+    }
+
+    /**
+     * @brief read into registered buffer, buf should be borrowed by the current context
+     *
+     */
+    tcp_read_fixed_awaiter read_fixed(fixed_buffer& buf, size_t len) noexcept
+    {
+        return tcp_read_fixed_awaiter(m_sockfd, buf, len);
+    }
+
+    /**
+     * @brief write from registered buffer, buf should be borrowed by the current context
+     *
+     */
+    tcp_write_fixed_awaiter write_fixed(fixed_buffer& buf, size_t len) noexcept
+    {
+        return tcp_write_fixed_awaiter(m_sockfd, buf, len);
+    }
+
+    /**
+     * @brief start a multishot recv, received data is delivered in buffers selected
+     * from buffer ring, see tcp_recv_stream
+     *
+     */
+    tcp_recv_stream recv_multishot() noexcept { return tcp_recv_stream(m_sockfd); }
+
+    /**
+     * @brief send len bytes of file fd from offset by splice, see send_file_awaiter
+     *
+     */
+    send_file_awaiter send_file(int fd, uint64_t offset, size_t len) noexcept
+    {
+        return send_file_awaiter(m_sockfd, fd, offset, len);
+    }
+
     tcp_close_awaiter close() noexcept { return tcp_close_awaiter(m_sockfd); }
 
 private:
     int m_sockfd;
 };
 
+struct listen_options
+{
+    int backlog{::coro::config::kBacklog};
+    /**
+     * @brief set SO_REUSEPORT, so every context can own a listener of the same port and
+     * kernel balances new connections among them
+     *
+     */
+    bool reuse_port{false};
+};
+
 class tcp_server
 {
 public:
     explicit tcp_server(int port = ::coro::config::kDefaultPort) noexcept : tcp_server(nullptr, port) {}
-    tcp_server(const char* addr, int port) noexcept;
+
+    /**
+     * @brief listen on addr:port, addr can be ipv4 or ipv6, nullptr means any ipv4 address
+     * and "::" means any address of both ipv4 and ipv6
+     *
+     */
+    tcp_server(const char* addr, int port, listen_options opts = {}) noexcept;
 
     tcp_accept_awaiter accept(int flags = 0) noexcept;
 
+    /**
+     * @brief start a multishot accept, see tcp_accept_stream
+     *
+     */
+    tcp_accept_stream accept_stream(int flags = 0) noexcept;
+
 private:
-    int         m_listenfd;
-    int         m_port;
-    sockaddr_in m_servaddr;
+    int              m_listenfd;
+    int              m_port;
+    sockaddr_storage m_servaddr;
 };
 
 class tcp_client
 {
 public:
+    /**
+     * @brief prepare a socket to connect to addr:port, addr can be ipv4 or ipv6
+     *
+     */
     tcp_client(const char* addr, int port) noexcept;
 
     tcp_connect_awaiter connect(int flags = 0) noexcept;
 
 private:
-    int         m_clientfd;
-    int         m_port;
-    sockaddr_in m_servaddr;
+    int              m_clientfd;
+    int              m_port;
+    sockaddr_storage m_servaddr;
+    socklen_t        m_addrlen;
 };
 
+/**
+ * @brief fill out with ipv4 or ipv6 address, addr nullptr means any ipv4 address
+ *
+ * @return socklen_t length of address, 0 if addr is invalid
+ */
+auto make_sockaddr(const char* addr, int port, sockaddr_storage* out) noexcept -> socklen_t;
+
 }; // namespace coro::net
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <arpa/inet.h>
+#include <cassert>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "coro/net/io_awaiter.hpp"
+#include "coro/net/io_stream.hpp"
+#include "coro/net/tcp.hpp"
+
+namespace coro::net
+{
+
+class udp_socket
+{
+public:
+    /**
+     * @brief create an unbound udp socket, kernel binds it when it first sends
+     *
+     */
+    udp_socket() noexcept;
+
+    /**
+     * @brief create an udp socket bound to addr:port, addr can be ipv4 or ipv6, nullptr means any ipv4 address
+     *
+     * @note fd() is -1 if addr is invalid or bind fails, see error()
+     */
+    udp_socket(const char* addr, int port) noexcept;
+
+    inline auto fd() const noexcept -> int { return m_sockfd; }
+
+    /**
+     * @brief return 0 if socket is ready, otherwise negative errno of creating or binding it
+     *
+     */
+    inline auto error() const noexcept -> int { return m_err; }
+
+    /**
+     * @brief receive one datagram, co_await returns its length or negative errno
+     *
+     * @param from filled with sender address if not nullptr
+     */
+    udp_recvfrom_awaiter recv_from(char* buf, size_t len, sockaddr_storage* from = nullptr) noexcept
+    {
+        return udp_recvfrom_awaiter(m_sockfd, buf, len, reinterpret_cast<sockaddr*>(from), sizeof(sockaddr_storage));
+    }
+
+    /**
+     * @brief send one datagram to ipv4 or ipv6 address to, e.g. the address filled by recv_from
+     *
+     */
+    udp_sendto_awaiter send_to(const char* buf, size_t len, const sockaddr* to) noexcept
+    {
+        return udp_sendto_awaiter(m_sockfd, buf, len, to);
+    }
+
+    /**
+     * @brief send one datagram to addr:port, co_await returns -EINVAL if addr is invalid
+     *
+     */
+    udp_sendto_awaiter send_to(const char* buf, size_t len, const char* addr, int port) noexcept
+    {
+        return udp_sendto_awaiter(m_sockfd, buf, len, addr, port);
+    }
+
+    /**
+     * @brief start a multishot recvmsg for batched receiving, see udp_recv_stream
+     *
+     */
+    udp_recv_stream recv_stream() noexcept { return udp_recv_stream(m_sockfd); }
+
+    tcp_close_awaiter close() noexcept { return tcp_close_awaiter(m_sockfd); }
+
+private:
+    int m_sockfd;
+    int m_err{0};
+};
+
+}; // namespace coro::net
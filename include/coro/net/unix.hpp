@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <span>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "coro/net/io_awaiter.hpp"
+#include "coro/net/io_stream.hpp"
+#include "coro/net/tcp.hpp"
+
+namespace coro::net
+{
+/**
+ * @brief unix_connector is a connected unix domain socket, it reads and writes
+ * by the same awaiters as tcp_connector and can pass fds to peer
+ *
+ * @note for SOCK_SEQPACKET socket every write is a message and every read returns one message
+ */
+class unix_connector : public tcp_connector
+{
+public:
+    explicit unix_connector(int sockfd) noexcept : tcp_connector(sockfd) {}
+
+    /**
+     * @brief send fds to peer with data in buf by SCM_RIGHTS, peer gets duplicates of fds,
+     * len must be at least 1 because ancillary data can't be sent alone
+     *
+     * @param fds at most kMaxPassFds fds, or the send fails with -EINVAL, they can be closed once co_await returns
+     */
+    unix_send_fds_awaiter send_fds(std::span<const int> fds, const char* buf, size_t len) noexcept
+    {
+        return unix_send_fds_awaiter(fd(), fds, buf, len);
+    }
+
+    /**
+     * @brief receive data into buf and fds sent by peer into fds, slots not filled are -1,
+     * received fds are close-on-exec and owned by caller
+     *
+     */
+    unix_recv_fds_awaiter recv_fds(std::span<int> fds, char* buf, size_t len) noexcept
+    {
+        return unix_recv_fds_awaiter(fd(), fds, buf, len);
+    }
+};
+
+class unix_server
+{
+public:
+    /**
+     * @brief listen on path, an existing socket file at path is removed first
+     *
+     * @param type SOCK_STREAM or SOCK_SEQPACKET
+     */
+    explicit unix_server(const char* path, int type = SOCK_STREAM) noexcept;
+
+    tcp_accept_awaiter accept(int flags = 0) noexcept;
+
+    /**
+     * @brief start a multishot accept, see tcp_accept_stream
+     *
+     */
+    tcp_accept_stream accept_stream(int flags = 0) noexcept;
+
+private:
+    int         m_listenfd;
+    sockaddr_un m_servaddr;
+};
+
+class unix_client
+{
+public:
+    /**
+     * @brief prepare a socket to connect to path
+     *
+     * @param type SOCK_STREAM or SOCK_SEQPACKET, must be the same as server
+     */
+    explicit unix_client(const char* path, int type = SOCK_STREAM) noexcept;
+
+    tcp_connect_awaiter connect() noexcept;
+
+private:
+    int         m_clientfd;
+    sockaddr_un m_servaddr;
+};
+
+/**
+ * @brief create a pair of connected nonblocking unix domain sockets
+ *
+ * @param type SOCK_STREAM or SOCK_SEQPACKET
+ * @return std::array<int, 2> both are -1 if creation fails
+ */
+auto make_socketpair(int type = SOCK_STREAM) noexcept -> std::array<int, 2>;
+
+}; // namespace coro::net
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <coroutine>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "coro/net/buffered_stream.hpp"
+#include "coro/net/tcp.hpp"
+#include "coro/resp/parser.hpp"
+#include "coro/task.hpp"
+
+namespace coro::resp
+{
+/**
+ * @brief client sends commands over one connection, commands issued by coroutines running
+ * at the same time are pipelined: they are written by one write and their replies are read in
+ * batches and handed back in the order the commands were issued, e.g. coroutines spawned by
+ * submit_to_context() that each co_await cli.command("GET", key) share round trips
+ *
+ * @note client is not thread-safe, all commands must be issued on the context which connects it
+ *
+ * @note out-of-band push replies of resp3 are dropped, a reply larger than
+ * config::kStreamBufMaxSize fails the connection
+ */
+class client
+{
+    // command waiting for its reply, lives in the frame of command()
+    struct pending
+    {
+        value                   reply;
+        std::coroutine_handle<> handle{nullptr};
+        pending*                next{nullptr};
+        bool                    done{false};
+        bool                    lead{false}; // handed the reader role
+    };
+
+    struct pending_awaiter
+    {
+        pending& node;
+
+        auto await_ready() noexcept -> bool { return node.done || node.lead; }
+
+        auto await_suspend(std::coroutine_handle<> handle) noexcept -> void { node.handle = handle; }
+
+        auto await_resume() noexcept -> void {}
+    };
+
+public:
+    client(const char* addr, int port) noexcept : m_client(addr, port) {}
+
+    client(const client&)                    = delete;
+    auto operator=(const client&) -> client& = delete;
+
+    /**
+     * @brief connect to server
+     *
+     * @return task<int> 0 or negative errno
+     */
+    auto connect() -> task<int>;
+
+    /**
+     * @brief send a command and wait for its reply
+     *
+     *     auto reply = co_await cli.command("SET", key, "1");
+     *
+     * @param args convertible to std::string_view, they must stay valid until co_await returns
+     * @return task<value> reply, an error value if the connection fails
+     */
+    template<typename... args_type>
+    auto command(const args_type&... args) -> task<value>
+    {
+        const std::string_view argv[] = {std::string_view(args)...};
+        co_return co_await execute(argv);
+    }
+
+    /**
+     * @brief send a command given as argument list and wait for its reply
+     *
+     * @param args encoded when the task starts, they must stay valid until then
+     * @return task<value> reply, an error value if the connection fails
+     */
+    auto execute(std::span<const std::string_view> args) -> task<value>;
+
+    /**
+     * @brief close connection, all commands must have completed
+     *
+     */
+    auto close() -> task<int>;
+
+    inline auto connected() const noexcept -> bool { return m_stream != nullptr && !m_broken; }
+
+private:
+    // writer role, send encoded commands until nothing is left
+    auto send_out() -> task<>;
+
+    // reader role, hand replies to pending commands until self gets its reply
+    auto read_replies(pending& self) -> task<>;
+
+    auto push(pending* node) noexcept -> void;
+
+    auto pop() noexcept -> pending*;
+
+    // complete node and wake it if it is waiting
+    auto finish(pending* node, value reply) noexcept -> void;
+
+    // complete all pending commands with error and mark connection broken
+    auto fail_all(std::string_view reason) noexcept -> void;
+
+private:
+    net::tcp_client                       m_client;
+    std::unique_ptr<net::buffered_stream> m_stream;
+    parser                                m_parser;
+    std::string                           m_out;     // commands not sent yet
+    std::string                           m_sending; // commands being sent
+    pending*                              m_head{nullptr};
+    pending*                              m_tail{nullptr};
+    bool                                  m_writing{false};
+    bool                                  m_reading{false};
+    bool                                  m_broken{false};
+};
+
+}; // namespace coro::resp
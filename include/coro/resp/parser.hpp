@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace coro::resp
+{
+enum class type : uint8_t
+{
+    null,
+    simple_string,
+    error,
+    integer,
+    bulk_string,
+    array,
+    // resp3 only
+    boolean,
+    double_number,
+    big_number,
+    bulk_error,
+    verbatim_string,
+    map,
+    set,
+    push
+};
+
+/**
+ * @brief value is a decoded reply, strings are copied out of the read buffer
+ *
+ * @note elements of map are keys and values interleaved, null bulk string and null array
+ * of resp2 are both decoded as type::null
+ */
+struct value
+{
+    type               kind{type::null};
+    int64_t            integer{0}; // integer, and boolean as 0 or 1
+    double             number{0};
+    std::string        str; // simple/bulk/verbatim string, error message and big number
+    std::vector<value> elements;
+
+    inline auto is_error() const noexcept -> bool { return kind == type::error || kind == type::bulk_error; }
+
+    inline auto is_null() const noexcept -> bool { return kind == type::null; }
+};
+
+/**
+ * @brief incremental resp2/resp3 parser, data can be fed in any pieces, every complete element is
+ * consumed at once and partial aggregates are kept by parser, so no byte is parsed twice
+ *
+ * @note attributes (|) are parsed and dropped, streamed strings and aggregates (?) are rejected
+ */
+class parser
+{
+public:
+    /**
+     * @brief parse elements at the front of data until a value completes or data runs out
+     *
+     * @return int number of bytes consumed, the rest must be fed again with more data,
+     * -1 if data violates protocol
+     */
+    auto feed(std::string_view data) -> int;
+
+    // return true if a complete value can be taken
+    inline auto done() const noexcept -> bool { return m_done; }
+
+    /**
+     * @brief take the complete value and get ready for the next one
+     *
+     */
+    auto take() noexcept -> value;
+
+    /**
+     * @brief drop partial state, e.g. after a protocol error
+     *
+     */
+    auto reset() noexcept -> void;
+
+private:
+    struct frame
+    {
+        value   val;
+        int64_t remain;  // elements still missing
+        bool    discard; // attribute, dropped when complete
+    };
+
+    // attach a complete element to the innermost aggregate, complete aggregates bubble up
+    auto complete(value val) -> void;
+
+private:
+    std::vector<frame> m_stack;
+    value              m_result;
+    bool               m_done{false};
+};
+
+/**
+ * @brief append a command encoded as an array of bulk strings to out
+ *
+ */
+auto encode_command(std::string& out, std::span<const std::string_view> args) -> void;
+
+}; // namespace coro::resp
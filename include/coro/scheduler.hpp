@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <memory>
+#include <span>
 #include <thread>
 #include <vector>
 
@@ -51,6 +52,48 @@ public:
         get_instance()->submit_task_impl(handle);
     }
 
+    /**
+     * @brief submit a batch of tasks, the batch is split into contiguous chunks and dispatcher
+     * places every chunk, so each target context is woken up only once per chunk
+     *
+     * @param tasks
+     */
+    static inline auto submit_batch(std::span<task<void>> tasks) noexcept -> void
+    {
+        std::vector<std::coroutine_handle<>> handles;
+        handles.reserve(tasks.size());
+        for (auto& task : tasks)
+        {
+            handles.push_back(task.handle());
+            task.detach();
+        }
+        submit_batch(std::span<std::coroutine_handle<>>(handles));
+    }
+
+    static inline auto submit_batch(std::span<std::coroutine_handle<>> handles) noexcept -> void
+    {
+        get_instance()->submit_batch_impl(handles);
+    }
+
+    /**
+     * @brief submit one task built by factory to every context, e.g. every context runs its own
+     * SO_REUSEPORT listener, so connections accepted by a context are served by itself
+     *
+     * @param factory callable returns task<void>, called once per context
+     */
+    template<typename task_factory>
+    static auto submit_to_each(task_factory&& factory) noexcept -> void
+    {
+        auto sc = get_instance();
+        for (size_t i = 0; i < sc->m_ctx_cnt; i++)
+        {
+            task<void> task   = factory();
+            auto       handle = task.handle();
+            task.detach();
+            sc->m_ctxs[i]->submit_task(handle);
+        }
+    }
+
 private:
     static auto get_instance() noexcept -> scheduler*
     {
@@ -66,6 +109,8 @@ private:
 
     [[CORO_TEST_USED(lab2b)]] auto submit_task_impl(std::coroutine_handle<> handle) noexcept -> void;
 
+    auto submit_batch_impl(std::span<std::coroutine_handle<>> handles) noexcept -> void;
+
     // TODO[lab2b]: Add more function if you need
 
 private:
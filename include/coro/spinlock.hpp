@@ -13,6 +13,24 @@ using std::memory_order_acquire;
 using std::memory_order_relaxed;
 using std::memory_order_release;
 
+/**
+ * @brief hint cpu that caller is spinning, issue X86 PAUSE or ARM YIELD instruction
+ * to reduce contention between hyper-threads
+ *
+ */
+inline auto cpu_relax() noexcept -> void
+{
+#if defined(_MSC_VER)
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
 struct spinlock
 {
     atomic<bool> lock_ = {0};
@@ -29,16 +47,7 @@ struct spinlock
             // Wait for lock to be released without generating cache misses
             while (lock_.load(memory_order_relaxed))
             {
-                // Issue X86 PAUSE or ARM YIELD instruction to reduce contention between
-                // hyper-threads
-
-#if defined(__GNUC__) || defined(__clang__)
-                __builtin_ia32_pause();
-#elif defined(_MSC_VER)
-                _mm_pause();
-#else
-                __builtin_ia32_pause();
-#endif
+                cpu_relax();
             }
         }
     }
@@ -12,11 +12,15 @@
 
 #include <cassert>
 #include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <new>
 #include <stdexcept>
 #include <utility>
 
 #include "coro/attribute.hpp"
 #include "coro/detail/container.hpp"
+#include "coro/frame_pool.hpp"
 
 namespace coro
 {
@@ -44,6 +48,124 @@ struct promise_base
     promise_base() noexcept = default;
     ~promise_base()         = default;
 
+    /**
+     * @brief every coroutine frame is followed by a pointer to the function which frees it,
+     * so frames from user allocator and default frames share the same operator delete
+     *
+     */
+    using dealloc_fn = void (*)(void* ptr, size_t size) noexcept;
+
+    static auto operator new(size_t size) -> void*
+    {
+        void* ptr;
+        if constexpr (config::kEnableFramePool)
+        {
+            ptr = frame_pool::allocate(fn_offset(size) + sizeof(dealloc_fn));
+        }
+        else
+        {
+            ptr = ::operator new(fn_offset(size) + sizeof(dealloc_fn));
+        }
+        set_dealloc_fn(ptr, size, &default_dealloc);
+        return ptr;
+    }
+
+    /**
+     * @brief allocate frame from alloc if coroutine is declared as
+     * task<T> f(std::allocator_arg_t, Alloc alloc, args...), a copy of alloc is stored
+     * after the frame and used to free it
+     *
+     */
+    template<typename Alloc, typename... Args>
+    static auto operator new(size_t size, std::allocator_arg_t, const Alloc& alloc, const Args&...) -> void*
+    {
+        return alloc_frame(size, alloc);
+    }
+
+    // member function coroutine, the first argument is the object
+    template<typename This, typename Alloc, typename... Args>
+    static auto operator new(size_t size, const This&, std::allocator_arg_t, const Alloc& alloc, const Args&...)
+        -> void*
+    {
+        return alloc_frame(size, alloc);
+    }
+
+    static auto operator delete(void* ptr, size_t size) noexcept -> void
+    {
+        (*reinterpret_cast<dealloc_fn*>(static_cast<std::byte*>(ptr) + fn_offset(size)))(ptr, size);
+    }
+
+private:
+    // allocation unit of user allocator, keep the frame aligned as default operator new does
+    struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) frame_unit
+    {
+        std::byte data[__STDCPP_DEFAULT_NEW_ALIGNMENT__];
+    };
+
+    template<typename Alloc>
+    using frame_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<frame_unit>;
+
+    static constexpr auto align_up(size_t size, size_t align) noexcept -> size_t
+    {
+        return (size + align - 1) & ~(align - 1);
+    }
+
+    static constexpr auto fn_offset(size_t size) noexcept -> size_t { return align_up(size, alignof(dealloc_fn)); }
+
+    template<typename Alloc>
+    static constexpr auto alloc_offset(size_t size) noexcept -> size_t
+    {
+        return align_up(fn_offset(size) + sizeof(dealloc_fn), alignof(frame_alloc<Alloc>));
+    }
+
+    template<typename Alloc>
+    static constexpr auto unit_num(size_t size) noexcept -> size_t
+    {
+        return (alloc_offset<Alloc>(size) + sizeof(frame_alloc<Alloc>) + sizeof(frame_unit) - 1) / sizeof(frame_unit);
+    }
+
+    static inline auto set_dealloc_fn(void* ptr, size_t size, dealloc_fn fn) noexcept -> void
+    {
+        *reinterpret_cast<dealloc_fn*>(static_cast<std::byte*>(ptr) + fn_offset(size)) = fn;
+    }
+
+    static auto default_dealloc(void* ptr, [[CORO_MAYBE_UNUSED]] size_t size) noexcept -> void
+    {
+        if constexpr (config::kEnableFramePool)
+        {
+            frame_pool::deallocate(ptr);
+        }
+        else
+        {
+            ::operator delete(ptr);
+        }
+    }
+
+    template<typename Alloc>
+    static auto alloc_frame(size_t size, const Alloc& alloc) -> void*
+    {
+        static_assert(alignof(frame_alloc<Alloc>) <= alignof(frame_unit), "allocator is overaligned");
+
+        frame_alloc<Alloc> falloc(alloc);
+        void*              ptr = std::allocator_traits<frame_alloc<Alloc>>::allocate(falloc, unit_num<Alloc>(size));
+        ::new (static_cast<std::byte*>(ptr) + alloc_offset<Alloc>(size)) frame_alloc<Alloc>(std::move(falloc));
+        set_dealloc_fn(ptr, size, &alloc_dealloc<Alloc>);
+        return ptr;
+    }
+
+    template<typename Alloc>
+    static auto alloc_dealloc(void* ptr, size_t size) noexcept -> void
+    {
+        auto stored = std::launder(
+            reinterpret_cast<frame_alloc<Alloc>*>(static_cast<std::byte*>(ptr) + alloc_offset<Alloc>(size)));
+        frame_alloc<Alloc> falloc(std::move(*stored));
+        stored->~frame_alloc<Alloc>();
+        std::allocator_traits<frame_alloc<Alloc>>::deallocate(
+            falloc, static_cast<frame_unit*>(ptr), unit_num<Alloc>(size));
+    }
+
+public:
+
     constexpr auto initial_suspend() noexcept { return std::suspend_always{}; }
 
     [[CORO_TEST_USED(lab1)]] auto final_suspend() noexcept -> std::suspend_always
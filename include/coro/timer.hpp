@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <coroutine>
+
+#include "config.h"
+#include "coro/detail/timer_wheel.hpp"
+#include "coro/net/io_info.hpp"
+#include "coro/uring_proxy.hpp"
+
+namespace coro
+{
+using std::chrono::steady_clock;
+
+namespace detail
+{
+/**
+ * @brief sleep_awaiter suspends coroutine until deadline without blocking the context,
+ * the timer is kept in timer wheel of local engine or submitted as an io_uring timeout,
+ * see config::kEnableTimerWheel
+ */
+class sleep_awaiter
+{
+public:
+    explicit sleep_awaiter(steady_clock::time_point deadline) noexcept : m_deadline(deadline) {}
+
+    auto await_ready() noexcept -> bool { return m_deadline <= steady_clock::now(); }
+
+    auto await_suspend(std::coroutine_handle<> handle) noexcept -> void;
+
+    constexpr auto await_resume() noexcept -> void {}
+
+private:
+    static auto callback(net::detail::io_info* data, int res) noexcept -> void;
+
+    steady_clock::time_point m_deadline;
+    timer_node               m_node;
+    net::detail::io_info     m_info;
+    __kernel_timespec        m_ts;
+};
+}; // namespace detail
+
+/**
+ * @brief suspend current coroutine for at least duration
+ *
+ */
+template<typename Rep, typename Period>
+inline auto sleep_for(std::chrono::duration<Rep, Period> duration) noexcept -> detail::sleep_awaiter
+{
+    return detail::sleep_awaiter(steady_clock::now() + std::chrono::ceil<steady_clock::duration>(duration));
+}
+
+/**
+ * @brief suspend current coroutine until deadline
+ *
+ */
+template<typename Duration>
+inline auto sleep_until(std::chrono::time_point<steady_clock, Duration> deadline) noexcept -> detail::sleep_awaiter
+{
+    return detail::sleep_awaiter(std::chrono::time_point_cast<steady_clock::duration>(deadline));
+}
+
+}; // namespace coro
@@ -1,16 +1,24 @@
 #pragma once
 
+#include <array>
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
+#include <fcntl.h>
 #include <functional>
 #include <liburing.h>
+#include <mutex>
+#include <poll.h>
 #include <sys/eventfd.h>
+#include <unistd.h>
+#include <vector>
 #ifdef ENABLE_POOLING
     #include <time.h>
 #endif // ENABLE_POOLING
 
 #include "config.h"
 #include "coro/attribute.hpp"
+#include "coro/spinlock.hpp"
 
 namespace coro::uring
 {
@@ -18,6 +26,37 @@ using ursptr     = io_uring_sqe*;
 using urcptr     = io_uring_cqe*;
 using urchandler = std::function<void(urcptr)>;
 
+// the lowest bit of cqe user data is set if cqe is posted by IORING_OP_MSG_RING and carries a task handle,
+// io_info and coroutine frame are both aligned so the bit is free, the bit alone marks an eventfd wakeup
+inline constexpr uint64_t kMsgRingTag = 1;
+
+/**
+ * @brief return if kernel supports IORING_OP_MSG_RING, kernel is probed only once
+ *
+ * @return true
+ * @return false
+ */
+inline auto msg_ring_supported() noexcept -> bool
+{
+    static const bool supported = []() -> bool
+    {
+        io_uring uring;
+        if (io_uring_queue_init(2, &uring, 0) != 0)
+        {
+            return false;
+        }
+        auto probe = io_uring_get_probe_ring(&uring);
+        bool ret   = probe != nullptr && io_uring_opcode_supported(probe, IORING_OP_MSG_RING);
+        if (probe != nullptr)
+        {
+            io_uring_free_probe(probe);
+        }
+        io_uring_queue_exit(&uring);
+        return ret;
+    }();
+    return supported;
+}
+
 class uring_proxy
 {
 public:
@@ -42,18 +81,255 @@ public:
         auto res = io_uring_queue_init_params(entry_length, &m_uring, &m_para);
         assert(res == 0 && "uring_proxy init uring failed");
 
-        res = io_uring_register_eventfd(&m_uring, m_efd);
-        assert(res == 0 && "uring_proxy bind event_fd to uring failed");
+        // tasks posted by IORING_OP_MSG_RING land in uring, so waiter blocks in uring and eventfd only
+        // needs to wake it up by a multishot poll, rather than being signaled by every cqe entry
+        m_wait_uring = config::kMsgRingWakeUp && msg_ring_supported();
+        if (m_wait_uring)
+        {
+            arm_wakeup();
+            io_uring_submit(&m_uring);
+        }
+        else
+        {
+            res = io_uring_register_eventfd(&m_uring, m_efd);
+            assert(res == 0 && "uring_proxy bind event_fd to uring failed");
+        }
+
+        if constexpr (config::kFixedBufferNum > 0)
+        {
+            register_fixed_buffers(config::kFixedBufferNum, config::kFixedBufferSize);
+        }
+
+        if constexpr (config::kBufRingEntries > 0)
+        {
+            setup_buf_ring(config::kBufRingEntries, config::kBufRingBufSize);
+        }
     }
 
+    /**
+     * @brief release uring and its buffers
+     *
+     * @warning must not be called while any fixed_buffer borrowed from this uring is alive, if so the
+     * registered buffers are leaked rather than freed so the borrower never touches freed memory
+     */
     auto deinit() noexcept -> void
     {
         // this operation cost too much time, so don't call this function
         // io_uring_unregister_eventfd(&m_uring);
 
+        if (m_br != nullptr)
+        {
+            io_uring_free_buf_ring(&m_uring, m_br, m_br_entries, kBufGroupId);
+            m_br = nullptr;
+            free(m_br_buf);
+            m_br_buf = nullptr;
+        }
+
         close(m_efd);
         m_efd = -1;
         io_uring_queue_exit(&m_uring);
+
+        // registered buffers are released by io_uring_queue_exit
+        {
+            std::lock_guard lk(m_fixed_lock);
+            assert(m_fixed_free.size() == m_fixed_num && "uring_proxy deinit with fixed buffer borrowed");
+            if (m_fixed_free.size() == m_fixed_num)
+            {
+                free(m_fixed_buf);
+            }
+            m_fixed_buf = nullptr;
+            m_fixed_num = 0;
+            m_fixed_free.clear();
+        }
+
+        for (auto& fds : m_pipes)
+        {
+            close(fds[0]);
+            close(fds[1]);
+        }
+        m_pipes.clear();
+    }
+
+    /**
+     * @brief register num buffers of len bytes to uring, return false if kernel refuses,
+     * then fixed buffer pool stays empty and borrow_fixed_buffer() always fails
+     *
+     * @param num
+     * @param len
+     * @return true
+     * @return false
+     */
+    auto register_fixed_buffers(size_t num, size_t len) noexcept -> bool
+    {
+        auto buf = static_cast<char*>(aligned_alloc(4096, num * len));
+        if (buf == nullptr)
+        {
+            return false;
+        }
+
+        std::vector<iovec> iovs(num);
+        for (size_t i = 0; i < num; i++)
+        {
+            iovs[i].iov_base = buf + i * len;
+            iovs[i].iov_len  = len;
+        }
+        if (io_uring_register_buffers(&m_uring, iovs.data(), num) != 0)
+        {
+            free(buf);
+            return false;
+        }
+
+        m_fixed_buf = buf;
+        m_fixed_len = len;
+        m_fixed_num = num;
+        m_fixed_free.reserve(num);
+        for (int i = num - 1; i >= 0; i--)
+        {
+            m_fixed_free.push_back(i);
+        }
+        return true;
+    }
+
+    /**
+     * @brief borrow one registered buffer, return its index or -1 if no buffer is free
+     *
+     * @note thread-safe
+     *
+     * @return int
+     */
+    auto borrow_fixed_buffer() noexcept -> int
+    {
+        std::lock_guard lk(m_fixed_lock);
+        if (m_fixed_free.empty())
+        {
+            return -1;
+        }
+        auto idx = m_fixed_free.back();
+        m_fixed_free.pop_back();
+        return idx;
+    }
+
+    /**
+     * @brief give back the registered buffer of index idx
+     *
+     * @note thread-safe
+     *
+     * @param idx
+     */
+    auto return_fixed_buffer(int idx) noexcept -> void
+    {
+        std::lock_guard lk(m_fixed_lock);
+        m_fixed_free.push_back(idx);
+    }
+
+    inline auto fixed_buffer_data(int idx) noexcept -> char* { return m_fixed_buf + idx * m_fixed_len; }
+
+    inline auto fixed_buffer_size() const noexcept -> size_t { return m_fixed_len; }
+
+    /**
+     * @brief setup buffer ring of group kBufGroupId with entries buffers of len bytes,
+     * return false if kernel doesn't support buffer ring
+     *
+     * @param entries must be power of two
+     * @param len
+     * @return true
+     * @return false
+     */
+    auto setup_buf_ring(unsigned int entries, size_t len) noexcept -> bool
+    {
+        auto buf = static_cast<char*>(aligned_alloc(4096, entries * len));
+        if (buf == nullptr)
+        {
+            return false;
+        }
+
+        int ret;
+        m_br = io_uring_setup_buf_ring(&m_uring, entries, kBufGroupId, 0, &ret);
+        if (m_br == nullptr)
+        {
+            free(buf);
+            return false;
+        }
+
+        m_br_buf     = buf;
+        m_br_len     = len;
+        m_br_entries = entries;
+        m_br_mask    = io_uring_buf_ring_mask(entries);
+        for (unsigned int i = 0; i < entries; i++)
+        {
+            io_uring_buf_ring_add(m_br, buf + i * len, len, i, m_br_mask, i);
+        }
+        io_uring_buf_ring_advance(m_br, entries);
+        return true;
+    }
+
+    /**
+     * @brief return if buffer ring is available
+     *
+     */
+    inline auto has_buf_ring() const noexcept -> bool { return m_br != nullptr; }
+
+    inline auto buf_ring_data(uint16_t bid) noexcept -> char* { return m_br_buf + bid * m_br_len; }
+
+    /**
+     * @brief give the buffer of bid back to buffer ring so kernel can select it again
+     *
+     * @note thread-safe
+     *
+     * @param bid
+     */
+    auto recycle_buf_ring(uint16_t bid) noexcept -> void
+    {
+        std::lock_guard lk(m_br_lock);
+        io_uring_buf_ring_add(m_br, buf_ring_data(bid), m_br_len, bid, m_br_mask, 0);
+        io_uring_buf_ring_advance(m_br, 1);
+    }
+
+    // buffer group id of buffer ring
+    static constexpr int kBufGroupId = 0;
+
+    /**
+     * @brief get an empty pipe for splice, return false if pipe can't be created
+     *
+     * @note only called by owner thread
+     *
+     * @param fds fds[0] is read end, fds[1] is write end
+     * @return true
+     * @return false
+     */
+    auto borrow_pipe(int (&fds)[2]) noexcept -> bool
+    {
+        if (!m_pipes.empty())
+        {
+            fds[0] = m_pipes.back()[0];
+            fds[1] = m_pipes.back()[1];
+            m_pipes.pop_back();
+            return true;
+        }
+
+        if (pipe2(fds, O_CLOEXEC) != 0)
+        {
+            return false;
+        }
+        // failure only means pipe keeps default capacity
+        fcntl(fds[1], F_SETPIPE_SZ, config::kSplicePipeSize);
+        return true;
+    }
+
+    /**
+     * @brief give pipe back, pipe must be empty
+     *
+     * @note only called by owner thread
+     */
+    auto return_pipe(int (&fds)[2]) noexcept -> void
+    {
+        if (m_pipes.size() < kPipeCacheNum)
+        {
+            m_pipes.push_back({fds[0], fds[1]});
+            return;
+        }
+        close(fds[0]);
+        close(fds[1]);
     }
 
     /**
@@ -105,6 +381,25 @@ public:
      */
     inline auto get_free_sqe() noexcept -> ursptr CORO_INLINE { return io_uring_get_sqe(&m_uring); }
 
+    /**
+     * @brief return number of free sqe entries
+     *
+     * @return unsigned int
+     */
+    inline auto free_sqe_num() const noexcept -> unsigned int { return io_uring_sq_space_left(&m_uring); }
+
+    /**
+     * @brief return if sqe is an entry of uring rather than staged by engine
+     *
+     * @param sqe
+     * @return true
+     * @return false
+     */
+    inline auto owns_sqe(ursptr sqe) const noexcept -> bool
+    {
+        return sqe >= m_uring.sq.sqes && sqe < m_uring.sq.sqes + m_uring.sq.ring_entries;
+    }
+
     /**
      * @brief submit all sqe entry and return the number of submitted sqe entry
      *
@@ -136,6 +431,54 @@ public:
         return i;
     }
 
+    /**
+     * @brief return if waiter should block in uring by wait_wakeup() rather than in eventfd,
+     * this is true when config::kMsgRingWakeUp is enabled and kernel supports IORING_OP_MSG_RING
+     *
+     * @return true
+     * @return false
+     */
+    inline auto wait_in_uring() const noexcept -> bool { return m_wait_uring; }
+
+    /**
+     * @brief arm the multishot poll on eventfd, its cqe entry has user data kMsgRingTag,
+     * return false if uring has no free sqe, then wait_wakeup() arms it again
+     *
+     * @note the poll must be armed again once its cqe entry comes without IORING_CQE_F_MORE
+     *
+     * @return true
+     * @return false
+     */
+    auto arm_wakeup() noexcept -> bool
+    {
+        auto sqe = io_uring_get_sqe(&m_uring);
+        if (sqe == nullptr)
+        {
+            m_wakeup_armed = false;
+            return false;
+        }
+        io_uring_prep_poll_multishot(sqe, m_efd, POLLIN);
+        io_uring_sqe_set_data64(sqe, kMsgRingTag);
+        m_wakeup_armed = true;
+        return true;
+    }
+
+    /**
+     * @brief submit pending sqe entries and block until uring has a cqe entry,
+     * eventfd write wakes it up by the multishot poll
+     *
+     * @note block function, only used if wait_in_uring() is true
+     */
+    auto wait_wakeup() noexcept -> void
+    {
+        if (!m_wakeup_armed && !arm_wakeup())
+        {
+            io_uring_submit(&m_uring);
+            arm_wakeup();
+        }
+        io_uring_submit_and_wait(&m_uring, 1);
+    }
+
     auto wait_eventfd() noexcept -> uint64_t
     {
         uint64_t u;
@@ -169,10 +512,186 @@ public:
      */
     inline auto cq_advance(unsigned int num) noexcept -> void CORO_INLINE { io_uring_cq_advance(&m_uring, num); }
 
+    /**
+     * @brief return the fd of uring, other rings use it as the target of IORING_OP_MSG_RING
+     *
+     * @return int
+     */
+    inline auto ring_fd() const noexcept -> int { return m_uring.ring_fd; }
+
 private:
     int             m_efd{0};
     io_uring_params m_para;
     io_uring        m_uring;
+    bool            m_wait_uring{false};
+    bool            m_wakeup_armed{false};
+
+    // registered buffers
+    char*            m_fixed_buf{nullptr};
+    size_t           m_fixed_len{0};
+    size_t           m_fixed_num{0};
+    std::vector<int> m_fixed_free;
+    detail::spinlock m_fixed_lock;
+
+    // provided buffer ring
+    io_uring_buf_ring* m_br{nullptr};
+    char*              m_br_buf{nullptr};
+    size_t             m_br_len{0};
+    unsigned int       m_br_entries{0};
+    int                m_br_mask{0};
+    detail::spinlock   m_br_lock;
+
+    // empty pipes cached for splice
+    static constexpr size_t         kPipeCacheNum = 16;
+    std::vector<std::array<int, 2>> m_pipes;
+};
+
+/**
+ * @brief a tiny uring only used to post IORING_OP_MSG_RING to other rings,
+ * so any thread can post cqe entry to engine without touching engine's own uring
+ *
+ * @note each thread owns one sender, use msg_ring_sender::local() to get it
+ *
+ * @note post doesn't wait for the message, its result is reaped later by the same thread, and
+ * fail handler of the post is called if the message fails
+ */
+class msg_ring_sender
+{
+public:
+    // called with target and data of the failed post, target is passed to post() by caller
+    using fail_handler = void (*)(void* target, uint64_t data);
+
+    msg_ring_sender() noexcept
+    {
+        m_inited = msg_ring_supported() && io_uring_queue_init(kEntryLength, &m_uring, 0) == 0;
+        m_valid  = m_inited;
+        for (unsigned int i = 0; i < kEntryLength; i++)
+        {
+            m_free[i] = i;
+        }
+        m_free_num = kEntryLength;
+    }
+
+    ~msg_ring_sender() noexcept
+    {
+        if (m_inited)
+        {
+            // the failed posts still have to be handed back
+            urcptr cqe;
+            while (m_free_num < kEntryLength && io_uring_wait_cqe(&m_uring, &cqe) == 0)
+            {
+                complete(cqe);
+            }
+            io_uring_queue_exit(&m_uring);
+        }
+    }
+
+    msg_ring_sender(const msg_ring_sender&)                    = delete;
+    msg_ring_sender(msg_ring_sender&&)                         = delete;
+    auto operator=(const msg_ring_sender&) -> msg_ring_sender& = delete;
+    auto operator=(msg_ring_sender&&) -> msg_ring_sender&      = delete;
+
+    static auto local() noexcept -> msg_ring_sender&
+    {
+        thread_local msg_ring_sender sender;
+        return sender;
+    }
+
+    /**
+     * @brief post a cqe entry whose user data is data to the ring of ring_fd
+     *
+     * @note the message is submitted by one io_uring_enter without waiting, kernel usually finishes it
+     * inside the submission, so its result is reaped right away, otherwise by a later post() or reap()
+     *
+     * @param ring_fd
+     * @param data
+     * @param on_fail called with target and data by the thread reaping the result if the message fails
+     * @param target
+     * @return true if the message is submitted, false means caller should fall back to other wakeup way
+     */
+    auto post(int ring_fd, uint64_t data, fail_handler on_fail, void* target) noexcept -> bool
+    {
+        if (!m_valid)
+        {
+            return false;
+        }
+        if (m_free_num == 0)
+        {
+            reap();
+            if (m_free_num == 0)
+            {
+                return false;
+            }
+        }
+
+        // every post is submitted at once, so a free slot always has a free sqe
+        auto sqe = io_uring_get_sqe(&m_uring);
+        auto idx = m_free[--m_free_num];
+
+        m_posts[idx] = post_info{.on_fail = on_fail, .target = target, .data = data};
+        io_uring_prep_msg_ring(sqe, ring_fd, 0, data, 0);
+        io_uring_sqe_set_data64(sqe, idx);
+
+        if (io_uring_submit(&m_uring) != 1)
+        {
+            // uring is in a bad state, never use it again
+            m_free[m_free_num++] = idx;
+            m_valid              = false;
+            return false;
+        }
+        reap();
+        return true;
+    }
+
+    /**
+     * @brief handle the finished posts without blocking, fail handler is called for each failed one
+     *
+     */
+    auto reap() noexcept -> void
+    {
+        if (m_free_num == kEntryLength)
+        {
+            return;
+        }
+        urcptr cqe;
+        while (io_uring_peek_cqe(&m_uring, &cqe) == 0)
+        {
+            complete(cqe);
+        }
+    }
+
+    inline auto valid() const noexcept -> bool { return m_valid; }
+
+private:
+    auto complete(urcptr cqe) noexcept -> void
+    {
+        auto idx  = static_cast<unsigned int>(io_uring_cqe_get_data64(cqe));
+        auto res  = cqe->res;
+        auto info = m_posts[idx];
+        io_uring_cqe_seen(&m_uring, cqe);
+        m_free[m_free_num++] = idx;
+        if (res < 0)
+        {
+            info.on_fail(info.target, info.data);
+        }
+    }
+
+    // max number of posts in flight, also the sqe number of uring
+    static constexpr unsigned int kEntryLength = 32;
+
+    struct post_info
+    {
+        fail_handler on_fail;
+        void*        target;
+        uint64_t     data;
+    };
+
+    bool                                   m_inited{false};
+    bool                                   m_valid{false};
+    io_uring                               m_uring;
+    std::array<post_info, kEntryLength>    m_posts;
+    std::array<unsigned int, kEntryLength> m_free; // indexes of free post slots
+    unsigned int                           m_free_num{0};
 };
 
 }; // namespace coro::uring
\ No newline at end of file
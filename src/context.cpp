@@ -55,4 +55,29 @@ auto context::run(stop_token token) noexcept -> void
     // TODO[lab2b]: Add you codes
 }
 
+auto context::try_steal() noexcept -> bool
+{
+    if constexpr (!detail::kWorkStealing)
+    {
+        return false;
+    }
+
+    auto& ctxs = scheduler::get_instance()->m_ctxs;
+    auto  cnt  = ctxs.size();
+    // start from the neighbour so that idle contexts don't rush to the same victim
+    for (size_t i = 1; i <= cnt; i++)
+    {
+        auto& victim = ctxs[(m_id + i) % cnt];
+        if (victim.get() == this)
+        {
+            continue;
+        }
+        if (m_engine.steal_from(victim->get_engine()) > 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 }; // namespace coro
\ No newline at end of file
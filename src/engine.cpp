@@ -1,10 +1,30 @@
+#include <utility>
+
+#include "coro/context.hpp"
 #include "coro/engine.hpp"
 #include "coro/net/io_info.hpp"
+#include "coro/spinlock.hpp"
 #include "coro/task.hpp"
 
 namespace coro::detail
 {
 using std::memory_order_relaxed;
+using std::chrono::steady_clock;
+
+static constexpr int64_t kTimerTickNs = config::kTimerTickMs * 1000000;
+
+static inline auto to_timespec(uint64_t tick, __kernel_timespec& ts) noexcept -> void
+{
+    auto ns    = static_cast<int64_t>(tick) * kTimerTickNs;
+    ts.tv_sec  = ns / 1000000000;
+    ts.tv_nsec = ns % 1000000000;
+}
+
+static inline auto now_tick() noexcept -> uint64_t
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(steady_clock::now().time_since_epoch()).count() /
+           kTimerTickNs;
+}
 
 auto engine::init() noexcept -> void
 {
@@ -18,6 +38,13 @@ auto engine::deinit() noexcept -> void
 
 auto engine::ready() noexcept -> bool
 {
+    if constexpr (kOwnerRunQueue)
+    {
+        if (!m_run_que.empty())
+        {
+            return true;
+        }
+    }
     // TODO[lab2a]: Add you codes
     return {};
 }
@@ -30,21 +57,106 @@ auto engine::get_free_urs() noexcept -> ursptr
 
 auto engine::num_task_schedule() noexcept -> size_t
 {
+    // lifo slot is private to owner thread, so it isn't counted here
+    size_t num = 0;
+    if constexpr (kWorkStealing)
+    {
+        num += m_run_que.size();
+    }
     // TODO[lab2a]: Add you codes
-    return {};
+    return num;
 }
 
 auto engine::schedule() noexcept -> coroutine_handle<>
 {
+    if constexpr (kOwnerRunQueue)
+    {
+        // lifo slot, then oldest local task, injection queue goes first once in a while
+        coroutine_handle<> handle;
+        if (m_run_que.pop(handle, m_task_queue))
+        {
+            return handle;
+        }
+    }
     // TODO[lab2a]: Add you codes
     return {};
 }
 
 auto engine::submit_task(coroutine_handle<> handle) noexcept -> void
 {
+    if constexpr (kOwnerRunQueue)
+    {
+        // owner thread doesn't need to be woken up, a wakeup displaced from lifo slot or over the
+        // streak limit goes to the back of local deque, or of task queue without work stealing
+        if (linfo.egn == this && m_run_que.push(handle))
+        {
+            return;
+        }
+    }
+    if constexpr (kMsgRingWakeUp)
+    {
+        // the cqe entry wakes engine up and carries handle, so task queue and eventfd are skipped,
+        // the handoff is counted before posting so engine never looks idle while it is in flight
+        if (linfo.egn != this && m_upxy.wait_in_uring())
+        {
+            m_msg_inflight.fetch_add(1, std::memory_order_release);
+            if (uring::msg_ring_sender::local().post(
+                    m_upxy.ring_fd(),
+                    reinterpret_cast<uint64_t>(handle.address()) | kMsgRingTag,
+                    &engine::msg_ring_failed,
+                    this))
+            {
+                return;
+            }
+            m_msg_inflight.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
     // TODO[lab2a]: Add you codes
 }
 
+auto engine::msg_ring_failed(void* target, uint64_t data) noexcept -> void
+{
+    auto egn = reinterpret_cast<engine*>(target);
+    egn->m_task_queue.push(coroutine_handle<>::from_address(reinterpret_cast<void*>(data & ~kMsgRingTag)));
+    // the task is queued before the handoff is dropped, so engine never looks idle in between
+    egn->m_msg_inflight.fetch_sub(1, std::memory_order_release);
+    egn->wake_up();
+}
+
+auto engine::submit_batch(std::span<coroutine_handle<>> handles) noexcept -> void
+{
+    wake_batch batch(*this);
+    for (auto handle : handles)
+    {
+        submit_task(handle);
+    }
+}
+
+auto engine::steal_from(engine& victim, size_t batch) noexcept -> size_t
+{
+    size_t             num = 0;
+    coroutine_handle<> handle;
+
+    // steal the oldest tasks from victim's local deque first, then drain its injection queue
+    while (num < batch && victim.m_run_que.steal(handle))
+    {
+        if (!m_run_que.push_back(handle))
+        {
+            m_task_queue.push(handle);
+        }
+        num++;
+    }
+    while (num < batch && victim.m_task_queue.try_pop(handle))
+    {
+        if (!m_run_que.push_back(handle))
+        {
+            m_task_queue.push(handle);
+        }
+        num++;
+    }
+    return num;
+}
+
 auto engine::exec_one_task() noexcept -> void
 {
     auto coro = schedule();
@@ -57,22 +169,282 @@ auto engine::exec_one_task() noexcept -> void
 
 auto engine::handle_cqe_entry(urcptr cqe) noexcept -> void
 {
+    if constexpr (kMsgRingWakeUp)
+    {
+        auto user_data = io_uring_cqe_get_data64(cqe);
+        if (user_data & kMsgRingTag)
+        {
+            auto handle = coroutine_handle<>::from_address(reinterpret_cast<void*>(user_data & ~kMsgRingTag));
+            if (!handle)
+            {
+                // eventfd wakeup, the multishot poll stops if kernel drops it
+                if (!(cqe->flags & IORING_CQE_F_MORE))
+                {
+                    m_upxy.arm_wakeup();
+                }
+                return;
+            }
+
+            // cqe is handled by owner thread, so the task takes the same way as a local wakeup
+            if constexpr (kOwnerRunQueue)
+            {
+                if (!m_run_que.push(handle))
+                {
+                    m_task_queue.push(handle);
+                }
+            }
+            else
+            {
+                m_task_queue.push(handle);
+            }
+            m_msg_inflight.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+    }
+
     auto data = reinterpret_cast<net::detail::io_info*>(io_uring_cqe_get_data(cqe));
-    data->cb(data, cqe->res);
+    if constexpr (kTrackIoLoad)
+    {
+        // multishot io keeps running until the cqe without IORING_CQE_F_MORE
+        if (!(cqe->flags & IORING_CQE_F_MORE))
+        {
+            m_io_inflight.store(m_io_inflight.load(memory_order_relaxed) - 1, memory_order_relaxed);
+        }
+    }
+    // callback tells the notification of zero copy send by IORING_CQE_F_NOTIF in flags
+    data->flags = cqe->flags;
+    data->cb(data, data->fail != 0 ? data->fail : cqe->res);
 }
 
 auto engine::poll_submit() noexcept -> void
 {
+    // uring slots are freed by the last submission, staged io goes first
+    if (m_overflow_head != nullptr) [[unlikely]]
+    {
+        flush_overflow();
+    }
     // TODO[lab2a]: Add you codes
 }
 
+auto engine::park() noexcept -> uint64_t
+{
+    if constexpr (kWorkStealing)
+    {
+        // engine is idle, take work from siblings before spinning
+        if (linfo.ctx != nullptr && linfo.ctx->try_steal())
+        {
+            return 0;
+        }
+    }
+    if constexpr (kMsgRingWakeUp)
+    {
+        // tasks of failed posts go back to task queues of their engines
+        uring::msg_ring_sender::local().reap();
+    }
+
+    for (int i = 0; i < config::kParkSpinRounds; i++)
+    {
+        if (ready() || m_upxy.peek_uring())
+        {
+            return 0;
+        }
+        cpu_relax();
+    }
+
+    m_sleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // task may arrive before submitter sees the flag, check again
+    if (ready() || m_upxy.peek_uring())
+    {
+        m_sleeping.store(false, std::memory_order_relaxed);
+        return 0;
+    }
+
+    uint64_t val = 1;
+    if (m_upxy.wait_in_uring())
+    {
+        m_upxy.wait_wakeup();
+    }
+    else
+    {
+        val = m_upxy.wait_eventfd();
+    }
+    m_sleeping.store(false, std::memory_order_relaxed);
+    return val;
+}
+
 auto engine::add_io_submit() noexcept -> void
 {
+    if (m_staging != nullptr) [[unlikely]]
+    {
+        // staged io isn't in uring yet, it will be recorded when flush_overflow() moves it into uring
+        auto node = std::exchange(m_staging, nullptr);
+        if (m_overflow_tail == nullptr)
+        {
+            m_overflow_head = node;
+        }
+        else
+        {
+            m_overflow_tail->next = node;
+        }
+        m_overflow_tail = node;
+        return;
+    }
+    if constexpr (kTrackIoLoad)
+    {
+        // single writer, no need for atomic rmw
+        m_io_inflight.store(m_io_inflight.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    }
     // TODO[lab2a]: Add you codes
 }
 
+auto engine::add_timer(timer_node* node, steady_clock::time_point deadline) noexcept -> void
+{
+    if (m_timer.empty())
+    {
+        m_timer.reset(now_tick());
+    }
+
+    // round up so timer never fires before deadline
+    auto ns      = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    node->expire = static_cast<uint64_t>((ns + kTimerTickNs - 1) / kTimerTickNs);
+    m_timer.add(node);
+    arm_timer();
+}
+
+auto engine::arm_timer() noexcept -> void
+{
+    auto next = m_timer.next_expire();
+    if (next >= m_timer_armed)
+    {
+        return;
+    }
+
+    auto sqe = get_sqe();
+
+    // steady_clock and io_uring absolute timeout both use CLOCK_MONOTONIC
+    if (m_timer_armed == timer_wheel::kNever)
+    {
+        m_timer_info.cb   = &engine::timer_callback;
+        m_timer_info.data = CASTPTR(this);
+        to_timespec(next, m_timer_ts);
+        io_uring_prep_timeout(sqe, &m_timer_ts, 0, IORING_TIMEOUT_ABS);
+        io_uring_sqe_set_data(sqe, &m_timer_info);
+    }
+    else
+    {
+        // if the timeout has fired, update fails with -ENOENT and timer_callback re-arms it
+        m_timer_update_info.cb = [](net::detail::io_info*, int) {};
+        to_timespec(next, m_timer_update_ts);
+        io_uring_prep_timeout_update(
+            sqe, &m_timer_update_ts, reinterpret_cast<__u64>(&m_timer_info), IORING_TIMEOUT_ABS);
+        io_uring_sqe_set_data(sqe, &m_timer_update_info);
+    }
+    add_io_submit();
+    m_timer_armed = next;
+}
+
+auto engine::timer_callback(net::detail::io_info* data, [[CORO_MAYBE_UNUSED]] int res) noexcept -> void
+{
+    auto egn           = reinterpret_cast<engine*>(data->data);
+    egn->m_timer_armed = timer_wheel::kNever;
+    egn->m_timer.advance(now_tick(), [egn](timer_node* node) { egn->submit_task(node->handle); });
+    egn->arm_timer();
+}
+
+auto engine::get_sqe() noexcept -> ursptr
+{
+    // keep the submission order, so io can't bypass staged io
+    if (m_overflow_head == nullptr) [[likely]]
+    {
+        if (auto sqe = get_free_urs(); sqe != nullptr) [[likely]]
+        {
+            return sqe;
+        }
+    }
+
+    m_overflow_cnt.store(m_overflow_cnt.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    m_staging = new overflow_node{};
+    return &m_staging->sqe;
+}
+
+auto engine::seal_chain(std::span<ursptr> chain) noexcept -> void
+{
+    // chain is in uring entirely, or it is a single sqe
+    if (chain.size() < 2 || m_upxy.owns_sqe(chain.back())) [[likely]]
+    {
+        return;
+    }
+    assert(chain.size() <= config::kEntryLength && "linked chain is longer than uring");
+
+    size_t in_uring = 0;
+    while (m_upxy.owns_sqe(chain[in_uring]))
+    {
+        in_uring++;
+    }
+
+    // sqes ahead got uring slots, so overflow list was empty and now begins with the rest of chain
+    auto head = reinterpret_cast<overflow_node*>(chain[in_uring]);
+    assert((in_uring == 0 || m_overflow_head == head) && "sqes of chain aren't taken in order");
+    for (size_t i = in_uring; i > 0; i--)
+    {
+        auto sqe = chain[i - 1];
+        head     = new overflow_node{.sqe = *sqe, .next = head};
+
+        // the slot is taken already, the nop is recorded as io and completed by m_nop_info,
+        // clear the sqe first so no flag or field of the moved io is left to the nop
+        *sqe = io_uring_sqe{};
+        io_uring_prep_nop(sqe);
+        io_uring_sqe_set_data(sqe, &m_nop_info);
+    }
+    if (in_uring > 0)
+    {
+        m_nop_info.cb   = [](net::detail::io_info*, int) {};
+        m_overflow_head = head;
+        m_overflow_cnt.store(m_overflow_cnt.load(memory_order_relaxed) + in_uring, memory_order_relaxed);
+    }
+    head->chain = chain.size();
+}
+
+auto engine::flush_overflow() noexcept -> void
+{
+    while (m_overflow_head != nullptr)
+    {
+        // a chain moves as a whole, or its link breaks at the end of this submission
+        if (m_upxy.free_sqe_num() < m_overflow_head->chain)
+        {
+            break;
+        }
+
+        for (auto num = m_overflow_head->chain; num > 0; num--)
+        {
+            auto sqe        = get_free_urs();
+            auto node       = m_overflow_head;
+            m_overflow_head = node->next;
+            *sqe            = node->sqe;
+            delete node;
+            add_io_submit();
+        }
+    }
+    if (m_overflow_head == nullptr)
+    {
+        m_overflow_tail = nullptr;
+    }
+}
+
 auto engine::empty_io() noexcept -> bool
 {
+    if (m_overflow_head != nullptr)
+    {
+        return false;
+    }
+    if constexpr (kMsgRingWakeUp)
+    {
+        if (m_msg_inflight.load(std::memory_order_acquire) > 0)
+        {
+            return false;
+        }
+    }
     // TODO[lab2a]: Add you codes
     return {};
 }
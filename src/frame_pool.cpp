@@ -0,0 +1,106 @@
+#include <mutex>
+#include <vector>
+
+#include "coro/frame_pool.hpp"
+
+namespace coro::detail
+{
+namespace
+{
+/**
+ * @brief record pools whose threads have exited, they are reused by new threads
+ *
+ * @note registry is never destroyed, because frames may be freed during static destruction
+ */
+struct pool_registry
+{
+    std::mutex               mtx;
+    std::vector<frame_pool*> orphans;
+};
+
+auto get_registry() noexcept -> pool_registry&
+{
+    static auto registry = new pool_registry();
+    return *registry;
+}
+}; // namespace
+
+/**
+ * @brief give pool back to registry when thread exits
+ *
+ */
+struct frame_pool_holder
+{
+    frame_pool* pool{nullptr};
+
+    ~frame_pool_holder() noexcept
+    {
+        if (pool != nullptr)
+        {
+            frame_pool::t_pool   = nullptr;
+            frame_pool::t_exited = true;
+            frame_pool::release_local(pool);
+        }
+    }
+};
+
+auto frame_pool::drain_remote() noexcept -> void
+{
+    auto node = m_remote.exchange(nullptr, std::memory_order_acquire);
+    while (node != nullptr)
+    {
+        auto next = node->next;
+        push_local(node, (reinterpret_cast<block_header*>(node) - 1)->cls);
+        node = next;
+    }
+}
+
+auto frame_pool::release_cache() noexcept -> void
+{
+    for (size_t cls = 0; cls < kClassNum; cls++)
+    {
+        auto node = m_free[cls];
+        while (node != nullptr)
+        {
+            auto next = node->next;
+            ::operator delete(reinterpret_cast<block_header*>(node) - 1);
+            node = next;
+        }
+        m_free[cls]     = nullptr;
+        m_free_cnt[cls] = 0;
+    }
+}
+
+auto frame_pool::acquire_local() noexcept -> frame_pool*
+{
+    thread_local frame_pool_holder holder;
+
+    auto& registry = get_registry();
+    {
+        std::lock_guard<std::mutex> lk(registry.mtx);
+        if (!registry.orphans.empty())
+        {
+            holder.pool = registry.orphans.back();
+            registry.orphans.pop_back();
+        }
+    }
+    if (holder.pool == nullptr)
+    {
+        holder.pool = new (std::nothrow) frame_pool();
+    }
+    t_pool = holder.pool;
+    return t_pool;
+}
+
+auto frame_pool::release_local(frame_pool* pool) noexcept -> void
+{
+    // blocks still in use will be pushed to remote list of the pool and reused after adoption
+    pool->drain_remote();
+    pool->release_cache();
+
+    auto&                       registry = get_registry();
+    std::lock_guard<std::mutex> lk(registry.mtx);
+    registry.orphans.push_back(pool);
+}
+
+}; // namespace coro::detail
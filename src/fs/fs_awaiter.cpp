@@ -0,0 +1,82 @@
+#include <algorithm>
+
+#include "coro/fs/fs_awaiter.hpp"
+#include "coro/scheduler.hpp"
+
+namespace coro::fs
+{
+using ::coro::detail::local_engine;
+using net::detail::io_type;
+
+namespace detail
+{
+base_fs_awaiter::base_fs_awaiter(io_type type) noexcept
+{
+    m_info.type = type;
+    m_info.cb   = &base_fs_awaiter::callback;
+}
+
+auto base_fs_awaiter::callback(io_info* data, int res) noexcept -> void
+{
+    data->result = res;
+    submit_to_context(data->handle);
+}
+}; // namespace detail
+
+open_awaiter::open_awaiter(int dfd, const char* path, int flags, mode_t mode) noexcept
+    : base_fs_awaiter(io_type::file_open)
+{
+    io_uring_prep_openat(m_urs, dfd, path, flags, mode);
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+read_awaiter::read_awaiter(int fd, void* buf, size_t len, uint64_t offset) noexcept
+    : base_fs_awaiter(io_type::file_read)
+{
+    io_uring_prep_read(m_urs, fd, buf, std::min(len, kMaxRwCount), offset);
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+write_awaiter::write_awaiter(int fd, const void* buf, size_t len, uint64_t offset) noexcept
+    : base_fs_awaiter(io_type::file_write)
+{
+    io_uring_prep_write(m_urs, fd, buf, std::min(len, kMaxRwCount), offset);
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+fsync_awaiter::fsync_awaiter(int fd, unsigned int flags) noexcept
+    : base_fs_awaiter(io_type::file_sync)
+{
+    io_uring_prep_fsync(m_urs, fd, flags);
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+fallocate_awaiter::fallocate_awaiter(int fd, int mode, uint64_t offset, uint64_t len) noexcept
+    : base_fs_awaiter(io_type::file_alloc)
+{
+    io_uring_prep_fallocate(m_urs, fd, mode, offset, len);
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+statx_awaiter::statx_awaiter(int dfd, const char* path, int flags, unsigned int mask, struct statx* buf) noexcept
+    : base_fs_awaiter(io_type::file_stat)
+{
+    io_uring_prep_statx(m_urs, dfd, path, flags, mask, buf);
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+close_awaiter::close_awaiter(int fd) noexcept
+    : base_fs_awaiter(io_type::file_close)
+{
+    io_uring_prep_close(m_urs, fd);
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+}; // namespace coro::fs
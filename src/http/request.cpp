@@ -0,0 +1,198 @@
+#include <bit>
+#include <charconv>
+#include <cstring>
+
+#ifdef __SSE2__
+    #include <emmintrin.h>
+#endif
+
+#include "coro/http/request.hpp"
+
+namespace coro::http
+{
+namespace detail
+{
+auto find_char(const char* begin, const char* end, char c) noexcept -> const char*
+{
+#ifdef __SSE2__
+    // compare 16 bytes per round, the tail shorter than 16 bytes goes to memchr
+    auto needle = _mm_set1_epi8(c);
+    for (; end - begin >= 16; begin += 16)
+    {
+        auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        if (auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle))); mask != 0)
+        {
+            return begin + std::countr_zero(mask);
+        }
+    }
+#endif
+    return static_cast<const char*>(memchr(begin, c, end - begin));
+}
+
+auto iequals(std::string_view lhs, std::string_view rhs) noexcept -> bool
+{
+    if (lhs.size() != rhs.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < lhs.size(); i++)
+    {
+        if ((lhs[i] | 0x20) != (rhs[i] | 0x20))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// strip optional whitespace around value and the '\r' of line ending
+static auto trim(const char* begin, const char* end) noexcept -> std::string_view
+{
+    while (begin < end && (*begin == ' ' || *begin == '\t'))
+    {
+        begin++;
+    }
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r'))
+    {
+        end--;
+    }
+    return std::string_view(begin, end - begin);
+}
+}; // namespace detail
+
+auto request::find(std::string_view name) const noexcept -> std::string_view
+{
+    for (auto& hdr : headers())
+    {
+        if (detail::iequals(hdr.name, name))
+        {
+            return hdr.value;
+        }
+    }
+    return std::string_view{};
+}
+
+static auto parse_request_line(const char* begin, const char* end, request& req) noexcept -> bool
+{
+    auto sp = detail::find_char(begin, end, ' ');
+    if (sp == nullptr || sp == begin)
+    {
+        return false;
+    }
+    req.method = std::string_view(begin, sp - begin);
+
+    begin = sp + 1;
+    sp    = detail::find_char(begin, end, ' ');
+    if (sp == nullptr || sp == begin)
+    {
+        return false;
+    }
+    req.target = std::string_view(begin, sp - begin);
+
+    auto version = detail::trim(sp + 1, end);
+    if (version.size() != 8 || version.substr(0, 7) != "HTTP/1." || (version[7] != '0' && version[7] != '1'))
+    {
+        return false;
+    }
+    req.minor_version = version[7] - '0';
+    return true;
+}
+
+// record headers the server itself depends on, has_length tells whether Content-Length is seen,
+// framing headers which may be read differently by a proxy in front are rejected
+static auto apply_header(request& req, const header& hdr, bool& has_length) noexcept -> bool
+{
+    if (detail::iequals(hdr.name, "content-length"))
+    {
+        uint64_t length = 0;
+        auto [ptr, ec]  = std::from_chars(hdr.value.data(), hdr.value.data() + hdr.value.size(), length);
+        if (ec != std::errc{} || ptr != hdr.value.data() + hdr.value.size())
+        {
+            return false;
+        }
+        // duplicate Content-Length must agree
+        if (has_length && length != req.content_length)
+        {
+            return false;
+        }
+        has_length         = true;
+        req.content_length = length;
+        return !req.chunked;
+    }
+    if (detail::iequals(hdr.name, "transfer-encoding"))
+    {
+        // only a single chunked coding is understood, anything else leaves body length unknown,
+        // and Transfer-Encoding together with Content-Length is ambiguous
+        if (req.chunked || has_length || !detail::iequals(hdr.value, "chunked"))
+        {
+            return false;
+        }
+        req.chunked = true;
+    }
+    else if (detail::iequals(hdr.name, "connection"))
+    {
+        if (detail::iequals(hdr.value, "close"))
+        {
+            req.keep_alive = false;
+        }
+        else if (detail::iequals(hdr.value, "keep-alive"))
+        {
+            req.keep_alive = true;
+        }
+    }
+    return true;
+}
+
+auto parse_request(std::string_view data, request& req) noexcept -> int
+{
+    auto begin = data.data();
+    auto end   = begin + data.size();
+
+    auto eol = detail::find_char(begin, end, '\n');
+    if (eol == nullptr)
+    {
+        return 0;
+    }
+
+    req.header_cnt     = 0;
+    req.body           = std::string_view{};
+    req.content_length = 0;
+    req.chunked        = false;
+    if (!parse_request_line(begin, eol, req))
+    {
+        return -1;
+    }
+    // http/1.0 closes connection by default
+    req.keep_alive  = req.minor_version == 1;
+    bool has_length = false;
+
+    for (auto line = eol + 1; line < end; line = eol + 1)
+    {
+        eol = detail::find_char(line, end, '\n');
+        if (eol == nullptr)
+        {
+            return 0;
+        }
+        if (eol == line || (eol == line + 1 && *line == '\r'))
+        {
+            // empty line ends header block
+            return static_cast<int>(eol + 1 - begin);
+        }
+
+        auto colon = detail::find_char(line, eol, ':');
+        if (colon == nullptr || colon == line || req.header_cnt == req.header_buf.size())
+        {
+            return -1;
+        }
+        auto& hdr = req.header_buf[req.header_cnt++];
+        hdr.name  = std::string_view(line, colon - line);
+        hdr.value = detail::trim(colon + 1, eol);
+        if (hdr.name.back() == ' ' || hdr.name.back() == '\t' || !apply_header(req, hdr, has_length))
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+}; // namespace coro::http
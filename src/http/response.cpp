@@ -0,0 +1,173 @@
+#include <charconv>
+#include <cstring>
+
+#include "coro/http/response.hpp"
+
+namespace coro::http
+{
+auto response::header(std::string_view name, std::string_view value) noexcept -> bool
+{
+    if (m_header_cnt == m_headers.size())
+    {
+        return false;
+    }
+    m_headers[m_header_cnt++] = http::header{name, value};
+    return true;
+}
+
+auto response::body(std::string_view data) noexcept -> bool
+{
+    if (data.empty())
+    {
+        return true;
+    }
+    if (m_piece_cnt == m_pieces.size())
+    {
+        return false;
+    }
+    m_pieces[m_piece_cnt++] = data;
+    return true;
+}
+
+auto response::write(std::string_view data) noexcept -> bool
+{
+    if (data.empty())
+    {
+        return true;
+    }
+    // text written back to back is contiguous in arena, merge it into the last piece
+    bool merge = !m_chunked && m_piece_cnt > 0 &&
+                 m_pieces[m_piece_cnt - 1].data() + m_pieces[m_piece_cnt - 1].size() == m_arena.top();
+    if (!merge && m_piece_cnt == m_pieces.size())
+    {
+        return false;
+    }
+
+    auto copied = m_arena.copy(data);
+    if (copied.data() == nullptr)
+    {
+        return false;
+    }
+    if (merge)
+    {
+        auto& last = m_pieces[m_piece_cnt - 1];
+        last       = std::string_view(last.data(), last.size() + copied.size());
+    }
+    else
+    {
+        m_pieces[m_piece_cnt++] = copied;
+    }
+    return true;
+}
+
+auto response::build_head() noexcept -> std::string_view
+{
+    constexpr std::string_view kVersion = "HTTP/1.1 ";
+    constexpr std::string_view kLength  = "Content-Length: ";
+    constexpr std::string_view kChunked = "Transfer-Encoding: chunked\r\n";
+    constexpr std::string_view kClose     = "Connection: close\r\n";
+    constexpr std::string_view kKeepAlive = "Connection: keep-alive\r\n";
+
+    // status line has room for three digits only
+    auto   status = m_status >= 100 && m_status <= 999 ? m_status : 500;
+    auto   reason = reason_phrase(status);
+    size_t size   = kVersion.size() + 4 + reason.size() + 2 + kLength.size() + 20 + 2 + kChunked.size() +
+                  kKeepAlive.size() + 2;
+    for (size_t i = 0; i < m_header_cnt; i++)
+    {
+        size += m_headers[i].name.size() + m_headers[i].value.size() + 4;
+    }
+
+    auto begin = m_arena.alloc(size);
+    if (begin == nullptr)
+    {
+        return std::string_view{};
+    }
+
+    auto pos    = begin;
+    auto append = [&pos](std::string_view str)
+    {
+        memcpy(pos, str.data(), str.size());
+        pos += str.size();
+    };
+
+    append(kVersion);
+    pos = std::to_chars(pos, pos + 3, status).ptr;
+    append(" ");
+    append(reason);
+    append("\r\n");
+    for (size_t i = 0; i < m_header_cnt; i++)
+    {
+        append(m_headers[i].name);
+        append(": ");
+        append(m_headers[i].value);
+        append("\r\n");
+    }
+    if (m_chunked)
+    {
+        append(kChunked);
+    }
+    else
+    {
+        size_t length = 0;
+        for (size_t i = 0; i < m_piece_cnt; i++)
+        {
+            length += m_pieces[i].size();
+        }
+        append(kLength);
+        pos = std::to_chars(pos, pos + 20, length).ptr;
+        append("\r\n");
+    }
+    if (!m_keep_alive)
+    {
+        append(kClose);
+    }
+    else if (m_http10)
+    {
+        // http/1.0 client closes connection unless keep-alive is confirmed
+        append(kKeepAlive);
+    }
+    append("\r\n");
+    return std::string_view(begin, pos - begin);
+}
+
+auto reason_phrase(int code) noexcept -> std::string_view
+{
+    switch (code)
+    {
+        case 200:
+            return "OK";
+        case 201:
+            return "Created";
+        case 204:
+            return "No Content";
+        case 301:
+            return "Moved Permanently";
+        case 302:
+            return "Found";
+        case 304:
+            return "Not Modified";
+        case 400:
+            return "Bad Request";
+        case 403:
+            return "Forbidden";
+        case 404:
+            return "Not Found";
+        case 405:
+            return "Method Not Allowed";
+        case 413:
+            return "Payload Too Large";
+        case 431:
+            return "Request Header Fields Too Large";
+        case 500:
+            return "Internal Server Error";
+        case 501:
+            return "Not Implemented";
+        case 503:
+            return "Service Unavailable";
+        default:
+            return "Unknown";
+    }
+}
+
+}; // namespace coro::http
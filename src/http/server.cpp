@@ -0,0 +1,164 @@
+#include <cerrno>
+#include <charconv>
+#include <string_view>
+
+#include "coro/context.hpp"
+#include "coro/http/server.hpp"
+#include "coro/log.hpp"
+
+namespace coro::http
+{
+// error response which closes connection
+static auto error_response(int code) noexcept -> std::string_view
+{
+    switch (code)
+    {
+        case 413:
+            return "HTTP/1.1 413 Payload Too Large\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        case 431:
+            return "HTTP/1.1 431 Request Header Fields Too Large\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        case 500:
+            return "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        case 501:
+            return "HTTP/1.1 501 Not Implemented\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        default:
+            return "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    }
+}
+
+auto server::serve(const char* addr, int port, net::listen_options opts) -> task<>
+{
+    auto listener = net::tcp_server(addr, port, opts);
+    auto stream   = listener.accept_stream();
+    log::info("http server start in {}", port);
+    while (!stream.finished())
+    {
+        int fd = co_await stream.next();
+        if (fd >= 0)
+        {
+            // connection stays on the context which accepts it
+            submit_to_context(session(fd));
+        }
+    }
+    // no-op if the stream has ended by itself
+    co_await stream.cancel();
+}
+
+auto server::session(int fd) -> task<>
+{
+    auto    stream = net::buffered_stream(net::tcp_connector(fd));
+    arena   ar(::coro::config::kHttpArenaSize);
+    request req;
+    int     error = 0;
+
+    while (true)
+    {
+        auto data = stream.buffered();
+        auto len  = parse_request(data, req);
+        if (len == 0)
+        {
+            if (data.size() >= ::coro::config::kHttpMaxHeaderSize)
+            {
+                error = 431;
+                break;
+            }
+            // all complete requests are answered, send responses before waiting for more data
+            if (co_await stream.flush() < 0 || (co_await stream.peek(data.size() + 1)).size() <= data.size())
+            {
+                break;
+            }
+            continue;
+        }
+        if (len < 0)
+        {
+            error = 400;
+            break;
+        }
+        if (req.chunked)
+        {
+            error = 501;
+            break;
+        }
+
+        size_t total = len + req.content_length;
+        if (req.content_length > ::coro::config::kStreamBufMaxSize || total > ::coro::config::kStreamBufMaxSize)
+        {
+            error = 413;
+            break;
+        }
+        if (total > data.size())
+        {
+            if ((co_await stream.peek(total)).size() < total)
+            {
+                break;
+            }
+            // buffer may be moved while waiting for body, views of request must be rebuilt
+            parse_request(stream.buffered(), req);
+        }
+        req.body = stream.buffered().substr(len, req.content_length);
+
+        response resp(ar, req);
+        m_handler(req, resp);
+        int ret = co_await send(stream, resp);
+        stream.consume(total);
+        ar.reset();
+        if (ret < 0 || !resp.keep_alive())
+        {
+            break;
+        }
+    }
+
+    if (error != 0)
+    {
+        co_await stream.write(error_response(error));
+    }
+    co_await stream.flush();
+    co_await stream.connector().close();
+}
+
+auto server::send(net::buffered_stream& stream, response& resp) -> task<int>
+{
+    auto head = resp.build_head();
+    if (head.data() == nullptr)
+    {
+        // arena can't hold the head, connection is closed after error response
+        resp.close();
+        co_return co_await stream.write(error_response(500));
+    }
+
+    int ret = co_await stream.write(head);
+    if (resp.head_only())
+    {
+        co_return ret;
+    }
+    for (size_t i = 0; i < resp.m_piece_cnt && ret == 0; i++)
+    {
+        auto piece = resp.m_pieces[i];
+        if (!resp.m_chunked)
+        {
+            ret = co_await stream.write(piece);
+            continue;
+        }
+
+        char size_line[24];
+        auto end = std::to_chars(size_line, size_line + 16, piece.size(), 16).ptr;
+        *end++   = '\r';
+        *end++   = '\n';
+        ret      = co_await stream.write(std::string_view(size_line, end - size_line));
+        if (ret == 0)
+        {
+            ret = co_await stream.write(piece);
+        }
+        if (ret == 0)
+        {
+            ret = co_await stream.write("\r\n");
+        }
+    }
+    if (resp.m_chunked && ret == 0)
+    {
+        ret = co_await stream.write("0\r\n\r\n");
+    }
+    co_return ret;
+}
+
+}; // namespace coro::http
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "coro/net/buffered_stream.hpp"
+
+namespace coro::net
+{
+buffered_stream::buffered_stream(tcp_connector conn, size_t init_size) noexcept
+    : m_conn(conn),
+      m_rbuf(new char[init_size]),
+      m_rcap(init_size)
+{
+    assert(init_size > 0 && "buffer size can't be zero");
+}
+
+auto buffered_stream::read_until(std::string_view delim) -> task<std::string_view>
+{
+    assert(!delim.empty() && "delim can't be empty");
+
+    size_t scanned = 0; // bytes after head known not to start delim
+    while (true)
+    {
+        auto data = buffered();
+        if (auto pos = data.find(delim, scanned); pos != std::string_view::npos)
+        {
+            auto view = data.substr(0, pos + delim.size());
+            consume(view.size());
+            co_return view;
+        }
+        // the tail may hold a partial delim, it is scanned again after next fill
+        scanned = data.size() >= delim.size() ? data.size() - delim.size() + 1 : 0;
+
+        if (!reserve(data.size() + 1) || co_await fill() <= 0)
+        {
+            co_return std::string_view{};
+        }
+    }
+}
+
+auto buffered_stream::read_exact(size_t n) -> task<std::string_view>
+{
+    if (!reserve(n))
+    {
+        co_return std::string_view{};
+    }
+    while (m_rtail - m_rhead < n)
+    {
+        if (co_await fill() <= 0)
+        {
+            co_return std::string_view{};
+        }
+    }
+
+    auto view = buffered().substr(0, n);
+    consume(n);
+    co_return view;
+}
+
+auto buffered_stream::peek(size_t n) -> task<std::string_view>
+{
+    if (!reserve(n))
+    {
+        co_return buffered();
+    }
+    while (m_rtail - m_rhead < n)
+    {
+        if (co_await fill() <= 0)
+        {
+            break;
+        }
+    }
+    co_return buffered();
+}
+
+auto buffered_stream::write(std::string_view data) -> task<int>
+{
+    if (data.empty())
+    {
+        co_return 0;
+    }
+    if (m_wlen + data.size() > m_wcap)
+    {
+        // pending bytes go out first, so the buffer never grows past the threshold by small writes
+        if (m_wlen > 0)
+        {
+            if (auto ret = co_await flush(); ret < 0)
+            {
+                co_return ret;
+            }
+        }
+        if (data.size() >= ::coro::config::kStreamFlushThreshold)
+        {
+            // large data bypasses the buffer
+            size_t sent = 0;
+            while (sent < data.size())
+            {
+                auto ret = co_await m_conn.write(const_cast<char*>(data.data()) + sent, data.size() - sent);
+                if (ret <= 0)
+                {
+                    co_return ret < 0 ? ret : -EPIPE;
+                }
+                sent += ret;
+            }
+            co_return 0;
+        }
+        if (m_wcap == 0)
+        {
+            m_wcap = ::coro::config::kStreamFlushThreshold;
+            m_wbuf.reset(new char[m_wcap]);
+        }
+    }
+
+    memcpy(m_wbuf.get() + m_wlen, data.data(), data.size());
+    m_wlen += data.size();
+    if (m_wlen >= ::coro::config::kStreamFlushThreshold)
+    {
+        co_return co_await flush();
+    }
+    co_return 0;
+}
+
+auto buffered_stream::flush() -> task<int>
+{
+    if (m_wlen == 0)
+    {
+        co_return 0;
+    }
+
+    size_t sent = 0;
+    int    ret  = 0;
+    while (sent < m_wlen)
+    {
+        ret = co_await m_conn.write(m_wbuf.get() + sent, m_wlen - sent);
+        if (ret <= 0)
+        {
+            ret = ret < 0 ? ret : -EPIPE;
+            break;
+        }
+        sent += ret;
+        ret = 0;
+    }
+
+    memmove(m_wbuf.get(), m_wbuf.get() + sent, m_wlen - sent);
+    m_wlen -= sent;
+    co_return ret;
+}
+
+auto buffered_stream::fill() -> task<int>
+{
+    if (m_rtail == m_rcap && !reserve(m_rtail - m_rhead + 1))
+    {
+        co_return m_result;
+    }
+    m_result = co_await m_conn.read(m_rbuf.get() + m_rtail, m_rcap - m_rtail);
+    if (m_result > 0)
+    {
+        m_rtail += m_result;
+    }
+    co_return m_result;
+}
+
+auto buffered_stream::reserve(size_t n) noexcept -> bool
+{
+    // n bytes are buffered already, a full buffer needs neither moving nor growing
+    if (m_rtail - m_rhead >= n)
+    {
+        return true;
+    }
+    if (n > ::coro::config::kStreamBufMaxSize)
+    {
+        m_result = -ENOBUFS;
+        return false;
+    }
+
+    size_t unread = m_rtail - m_rhead;
+    if (m_rcap - m_rhead >= n && m_rtail < m_rcap)
+    {
+        return true;
+    }
+
+    if (m_rcap >= n && m_rhead > 0)
+    {
+        // enough room after moving unread bytes to the front
+        memmove(m_rbuf.get(), m_rbuf.get() + m_rhead, unread);
+    }
+    else
+    {
+        size_t cap = m_rcap;
+        while (cap < n || cap == unread)
+        {
+            cap *= 2;
+        }
+        cap      = std::min(cap, ::coro::config::kStreamBufMaxSize);
+        auto buf = std::unique_ptr<char[]>(new char[cap]);
+        memcpy(buf.get(), m_rbuf.get() + m_rhead, unread);
+        m_rbuf = std::move(buf);
+        m_rcap = cap;
+    }
+    m_rhead = 0;
+    m_rtail = unread;
+    return true;
+}
+
+}; // namespace coro::net
@@ -1,8 +1,13 @@
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <cstring>
 #include <optional>
 #include <sys/socket.h>
 #include <unistd.h>
 
 #include "coro/net/io_awaiter.hpp"
+#include "coro/net/tcp.hpp"
 #include "coro/scheduler.hpp"
 
 namespace coro::net
@@ -75,6 +80,501 @@ auto tcp_write_awaiter::callback(io_info* data, int res) noexcept -> void
     submit_to_context(data->handle);
 }
 
+tcp_readv_awaiter::tcp_readv_awaiter(int sockfd, std::span<iovec> iov) noexcept
+{
+    m_info.type = io_type::tcp_read;
+    m_info.cb   = &tcp_readv_awaiter::callback;
+
+    io_uring_prep_readv(m_urs, sockfd, iov.data(), iov.size(), 0);
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+auto tcp_readv_awaiter::callback(io_info* data, int res) noexcept -> void
+{
+    data->result = res;
+    submit_to_context(data->handle);
+}
+
+tcp_writev_awaiter::tcp_writev_awaiter(int sockfd, std::span<const iovec> iov) noexcept
+{
+    m_info.type = io_type::tcp_write;
+    m_info.cb   = &tcp_writev_awaiter::callback;
+
+    io_uring_prep_writev(m_urs, sockfd, iov.data(), iov.size(), 0);
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+auto tcp_writev_awaiter::callback(io_info* data, int res) noexcept -> void
+{
+    data->result = res;
+    submit_to_context(data->handle);
+}
+
+tcp_recvmsg_awaiter::tcp_recvmsg_awaiter(int sockfd, std::span<iovec> iov, int flags) noexcept : m_msg{}
+{
+    m_info.type = io_type::tcp_read;
+    m_info.cb   = &tcp_recvmsg_awaiter::callback;
+
+    // kernel reads msghdr when sqe is submitted, awaiter is alive until coroutine resumes
+    m_msg.msg_iov    = iov.data();
+    m_msg.msg_iovlen = iov.size();
+    io_uring_prep_recvmsg(m_urs, sockfd, &m_msg, flags);
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+tcp_recvmsg_awaiter::tcp_recvmsg_awaiter(int sockfd, msghdr* msg, int flags) noexcept : m_msg{}
+{
+    m_info.type = io_type::tcp_read;
+    m_info.cb   = &tcp_recvmsg_awaiter::callback;
+
+    io_uring_prep_recvmsg(m_urs, sockfd, msg, flags);
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+auto tcp_recvmsg_awaiter::callback(io_info* data, int res) noexcept -> void
+{
+    data->result = res;
+    submit_to_context(data->handle);
+}
+
+tcp_sendmsg_awaiter::tcp_sendmsg_awaiter(int sockfd, std::span<const iovec> iov, int flags) noexcept : m_msg{}
+{
+    m_info.type = io_type::tcp_write;
+    m_info.cb   = &tcp_sendmsg_awaiter::callback;
+
+    m_msg.msg_iov    = const_cast<iovec*>(iov.data());
+    m_msg.msg_iovlen = iov.size();
+    io_uring_prep_sendmsg(m_urs, sockfd, &m_msg, flags);
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+tcp_sendmsg_awaiter::tcp_sendmsg_awaiter(int sockfd, const msghdr* msg, int flags) noexcept : m_msg{}
+{
+    m_info.type = io_type::tcp_write;
+    m_info.cb   = &tcp_sendmsg_awaiter::callback;
+
+    io_uring_prep_sendmsg(m_urs, sockfd, msg, flags);
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+auto tcp_sendmsg_awaiter::callback(io_info* data, int res) noexcept -> void
+{
+    data->result = res;
+    submit_to_context(data->handle);
+}
+
+udp_recvfrom_awaiter::udp_recvfrom_awaiter(
+    int sockfd, char* buf, size_t len, sockaddr* from, socklen_t fromlen) noexcept
+    : m_msg{},
+      m_iov{buf, len}
+{
+    m_info.type = io_type::tcp_read;
+    m_info.cb   = &udp_recvfrom_awaiter::callback;
+
+    m_msg.msg_name    = from;
+    m_msg.msg_namelen = from != nullptr ? fromlen : 0;
+    m_msg.msg_iov     = &m_iov;
+    m_msg.msg_iovlen  = 1;
+    io_uring_prep_recvmsg(m_urs, sockfd, &m_msg, 0);
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+auto udp_recvfrom_awaiter::callback(io_info* data, int res) noexcept -> void
+{
+    data->result = res;
+    submit_to_context(data->handle);
+}
+
+udp_sendto_awaiter::udp_sendto_awaiter(int sockfd, const char* buf, size_t len, const sockaddr* to) noexcept
+    : m_msg{},
+      m_iov{const_cast<char*>(buf), len},
+      m_to{}
+{
+    socklen_t tolen = 0;
+    if (to != nullptr && to->sa_family == AF_INET)
+    {
+        tolen = sizeof(sockaddr_in);
+    }
+    else if (to != nullptr && to->sa_family == AF_INET6)
+    {
+        tolen = sizeof(sockaddr_in6);
+    }
+    if (tolen != 0)
+    {
+        memcpy(&m_to, to, tolen);
+    }
+    prep_send(sockfd, tolen);
+}
+
+udp_sendto_awaiter::udp_sendto_awaiter(int sockfd, const char* buf, size_t len, const char* addr, int port) noexcept
+    : m_msg{},
+      m_iov{const_cast<char*>(buf), len}
+{
+    prep_send(sockfd, make_sockaddr(addr, port, &m_to));
+}
+
+auto udp_sendto_awaiter::prep_send(int sockfd, socklen_t tolen) noexcept -> void
+{
+    m_info.type = io_type::tcp_write;
+    m_info.cb   = &udp_sendto_awaiter::callback;
+
+    m_msg.msg_name    = &m_to;
+    m_msg.msg_namelen = tolen;
+    m_msg.msg_iov     = &m_iov;
+    m_msg.msg_iovlen  = 1;
+    if (tolen == 0)
+    {
+        prep_fail(-EINVAL);
+    }
+    else
+    {
+        io_uring_prep_sendmsg(m_urs, sockfd, &m_msg, 0);
+    }
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+auto udp_sendto_awaiter::callback(io_info* data, int res) noexcept -> void
+{
+    data->result = res;
+    submit_to_context(data->handle);
+}
+
+unix_send_fds_awaiter::unix_send_fds_awaiter(
+    int sockfd, std::span<const int> fds, const char* buf, size_t len) noexcept
+    : m_msg{},
+      m_iov{const_cast<char*>(buf), len}
+{
+    m_info.type = io_type::tcp_write;
+    m_info.cb   = &unix_send_fds_awaiter::callback;
+
+    // at least one byte of data must be sent with ancillary data
+    m_msg.msg_iov     = &m_iov;
+    m_msg.msg_iovlen  = 1;
+    m_msg.msg_control = m_ctrl;
+
+    if (fds.size() > kMaxPassFds)
+    {
+        // too many fds for control buffer
+        prep_fail(-EINVAL);
+        io_uring_sqe_set_data(m_urs, &m_info);
+        local_engine().add_io_submit();
+        return;
+    }
+
+    m_msg.msg_controllen = CMSG_SPACE(sizeof(int) * fds.size());
+
+    auto cmsg        = CMSG_FIRSTHDR(&m_msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type  = SCM_RIGHTS;
+    cmsg->cmsg_len   = CMSG_LEN(sizeof(int) * fds.size());
+    memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+
+    io_uring_prep_sendmsg(m_urs, sockfd, &m_msg, 0);
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+auto unix_send_fds_awaiter::callback(io_info* data, int res) noexcept -> void
+{
+    data->result = res;
+    submit_to_context(data->handle);
+}
+
+unix_recv_fds_awaiter::unix_recv_fds_awaiter(int sockfd, std::span<int> fds, char* buf, size_t len) noexcept
+    : m_msg{},
+      m_iov{buf, len},
+      m_fds(fds)
+{
+    m_info.type = io_type::tcp_read;
+    m_info.cb   = &unix_recv_fds_awaiter::callback;
+    m_info.data = CASTPTR(this);
+
+    std::fill(m_fds.begin(), m_fds.end(), -1);
+    m_msg.msg_iov        = &m_iov;
+    m_msg.msg_iovlen     = 1;
+    m_msg.msg_control    = m_ctrl;
+    m_msg.msg_controllen = CMSG_SPACE(sizeof(int) * std::min(fds.size(), kMaxPassFds));
+
+    io_uring_prep_recvmsg(m_urs, sockfd, &m_msg, MSG_CMSG_CLOEXEC);
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+auto unix_recv_fds_awaiter::callback(io_info* data, int res) noexcept -> void
+{
+    auto self = reinterpret_cast<unix_recv_fds_awaiter*>(data->data);
+    if (res >= 0)
+    {
+        // copy received fds out, fds exceeding control buffer are closed by kernel
+        size_t num = 0;
+        for (auto cmsg = CMSG_FIRSTHDR(&self->m_msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&self->m_msg, cmsg))
+        {
+            if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+            {
+                continue;
+            }
+            auto cnt = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            auto fds = reinterpret_cast<int*>(CMSG_DATA(cmsg));
+            for (size_t i = 0; i < cnt && num < self->m_fds.size(); i++)
+            {
+                self->m_fds[num++] = fds[i];
+            }
+        }
+    }
+    data->result = res;
+    submit_to_context(data->handle);
+}
+
+tcp_read_fixed_awaiter::tcp_read_fixed_awaiter(int sockfd, fixed_buffer& buf, size_t len) noexcept
+{
+    m_info.type = io_type::tcp_read;
+    m_info.cb   = &tcp_read_fixed_awaiter::callback;
+    len         = std::min(len, buf.size());
+
+    // buffer may be borrowed from another engine if task migrates, then fall back to normal recv
+    if (buf.registered_in(local_engine().get_uring()))
+    {
+        io_uring_prep_read_fixed(m_urs, sockfd, buf.data(), len, 0, buf.index());
+    }
+    else
+    {
+        io_uring_prep_recv(m_urs, sockfd, buf.data(), len, 0);
+    }
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+auto tcp_read_fixed_awaiter::callback(io_info* data, int res) noexcept -> void
+{
+    data->result = res;
+    submit_to_context(data->handle);
+}
+
+tcp_write_fixed_awaiter::tcp_write_fixed_awaiter(int sockfd, fixed_buffer& buf, size_t len) noexcept
+{
+    m_info.type = io_type::tcp_write;
+    m_info.cb   = &tcp_write_fixed_awaiter::callback;
+    len         = std::min(len, buf.size());
+
+    if (buf.registered_in(local_engine().get_uring()))
+    {
+        io_uring_prep_write_fixed(m_urs, sockfd, buf.data(), len, 0, buf.index());
+    }
+    else
+    {
+        io_uring_prep_send(m_urs, sockfd, buf.data(), len, 0);
+    }
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+auto tcp_write_fixed_awaiter::callback(io_info* data, int res) noexcept -> void
+{
+    data->result = res;
+    submit_to_context(data->handle);
+}
+
+tcp_write_zc_awaiter::tcp_write_zc_awaiter(
+    int sockfd, char* buf, size_t len, int flags, zc_tracker& tracker) noexcept
+    : m_tracker(tracker)
+{
+    assert(!tracker.m_pending && "zc_tracker is used by a running zero copy send");
+
+    // the send produces two cqe entries, the tracker outlives this awaiter and receives both
+    auto& info  = tracker.m_info;
+    info.type   = io_type::tcp_write;
+    info.cb     = &tcp_write_zc_awaiter::callback;
+    info.data   = CASTPTR(&tracker);
+    info.handle = nullptr;
+
+    tracker.m_pending = true;
+    io_uring_prep_send_zc(m_urs, sockfd, buf, len, flags, 0);
+    io_uring_sqe_set_data(m_urs, &info);
+    local_engine().add_io_submit();
+}
+
+auto tcp_write_zc_awaiter::callback(io_info* data, int res) noexcept -> void
+{
+    auto tracker = reinterpret_cast<zc_tracker*>(data->data);
+    if (data->flags & IORING_CQE_F_NOTIF)
+    {
+        // notification, kernel has released the buffer
+        tracker->m_pending = false;
+        if (auto waiter = tracker->m_waiter; waiter != nullptr)
+        {
+            tracker->m_waiter = nullptr;
+            submit_to_context(waiter);
+        }
+        return;
+    }
+
+    // without IORING_CQE_F_MORE no notification will follow, e.g. the send fails
+    if (!(data->flags & IORING_CQE_F_MORE))
+    {
+        tracker->m_pending = false;
+    }
+    data->result = res;
+    submit_to_context(data->handle);
+}
+
+splice_awaiter::splice_awaiter(
+    int fd_in, int64_t off_in, int fd_out, int64_t off_out, unsigned int len, unsigned int flags) noexcept
+{
+    m_info.type = io_type::tcp_write;
+    m_info.cb   = &splice_awaiter::callback;
+
+    io_uring_prep_splice(m_urs, fd_in, off_in, fd_out, off_out, len, flags);
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+auto splice_awaiter::callback(io_info* data, int res) noexcept -> void
+{
+    data->result = res;
+    submit_to_context(data->handle);
+}
+
+send_file_awaiter::send_file_awaiter(int sockfd, int fd, uint64_t offset, size_t len) noexcept
+    : m_sockfd(sockfd),
+      m_fd(fd),
+      m_offset(offset),
+      m_remain(len)
+{
+    for (auto info : {&m_in_info, &m_out_info})
+    {
+        info->type = io_type::tcp_write;
+        info->cb   = &send_file_awaiter::callback;
+        info->data = CASTPTR(this);
+    }
+
+    if (len == 0)
+    {
+        m_done = true;
+        return;
+    }
+    if (!local_engine().get_uring().borrow_pipe(m_pipe))
+    {
+        m_result = -errno;
+        m_done   = true;
+        return;
+    }
+    submit_round();
+}
+
+auto send_file_awaiter::submit_round() noexcept -> void
+{
+    auto& egn     = local_engine();
+    auto  out_len = m_piped;
+
+    m_in_submitted = (m_piped == 0);
+    m_in_res       = 0;
+    m_out_res      = 0;
+    m_wait         = 0;
+
+    coro::uring::ursptr in_sqe = nullptr;
+    if (m_in_submitted)
+    {
+        out_len = std::min<size_t>(m_remain, config::kSplicePipeSize);
+        in_sqe  = egn.get_sqe();
+        io_uring_prep_splice(in_sqe, m_fd, m_offset, m_pipe[1], -1, out_len, SPLICE_F_MOVE);
+        in_sqe->flags |= IOSQE_IO_LINK;
+        io_uring_sqe_set_data(in_sqe, &m_in_info);
+        egn.add_io_submit();
+        m_wait++;
+    }
+
+    auto sqe = egn.get_sqe();
+    io_uring_prep_splice(sqe, m_pipe[0], -1, m_sockfd, -1, out_len, SPLICE_F_MOVE);
+    io_uring_sqe_set_data(sqe, &m_out_info);
+    egn.add_io_submit();
+    m_wait++;
+
+    if (m_in_submitted)
+    {
+        coro::uring::ursptr chain[] = {in_sqe, sqe};
+        egn.seal_chain(chain);
+    }
+}
+
+auto send_file_awaiter::callback(io_info* data, int res) noexcept -> void
+{
+    auto self = reinterpret_cast<send_file_awaiter*>(data->data);
+    if (data == &self->m_in_info)
+    {
+        self->m_in_res = res;
+    }
+    else
+    {
+        self->m_out_res = res;
+    }
+
+    if (--self->m_wait == 0)
+    {
+        self->finish_round();
+    }
+}
+
+auto send_file_awaiter::finish_round() noexcept -> void
+{
+    if (m_in_submitted)
+    {
+        if (m_in_res < 0)
+        {
+            return finish(m_sent > 0 ? m_sent : m_in_res);
+        }
+        if (m_in_res == 0)
+        {
+            // file ends before len bytes
+            m_remain = 0;
+        }
+        m_piped += m_in_res;
+        m_offset += m_in_res;
+        m_remain -= std::min<size_t>(m_remain, m_in_res);
+    }
+
+    // a short splice into pipe breaks the link, then the socket step is cancelled and retried next round
+    if (m_out_res > 0)
+    {
+        m_piped -= m_out_res;
+        m_sent += m_out_res;
+    }
+    else if (m_out_res < 0 && m_out_res != -ECANCELED && m_out_res != -EAGAIN)
+    {
+        return finish(m_sent > 0 ? m_sent : m_out_res);
+    }
+
+    if (m_piped == 0 && m_remain == 0)
+    {
+        return finish(m_sent);
+    }
+    submit_round();
+}
+
+auto send_file_awaiter::finish(int64_t result) noexcept -> void
+{
+    // pipe still holding data can't be reused
+    if (m_piped == 0)
+    {
+        local_engine().get_uring().return_pipe(m_pipe);
+    }
+    else
+    {
+        close(m_pipe[0]);
+        close(m_pipe[1]);
+    }
+    m_result = result;
+    m_done   = true;
+    submit_to_context(m_handle);
+}
+
 tcp_close_awaiter::tcp_close_awaiter(int sockfd) noexcept
 {
     m_info.type = io_type::tcp_close;
@@ -0,0 +1,93 @@
+#include "coro/net/io_guard.hpp"
+#include "coro/scheduler.hpp"
+
+namespace coro::net::detail
+{
+using ::coro::detail::local_engine;
+
+io_guard::io_guard(finish_func finish) noexcept : m_finish(finish)
+{
+    for (auto info : {&m_io_info, &m_timeout_info, &m_cancel_info})
+    {
+        info->type = io_type::none;
+        info->cb   = &io_guard::callback;
+        info->data = CASTPTR(this);
+    }
+}
+
+auto io_guard::prepare(coro::uring::ursptr sqe, std::chrono::nanoseconds timeout, cancel_token* token) noexcept
+    -> void
+{
+    io_uring_sqe_set_data(sqe, &m_io_info);
+    if (token != nullptr && token->cancelled())
+    {
+        // sqe has been taken from uring, so turn it to nop rather than drop it
+        io_uring_prep_nop(sqe);
+        io_uring_sqe_set_data(sqe, &m_io_info);
+        m_res = -ECANCELED;
+        return;
+    }
+
+    if (timeout > std::chrono::nanoseconds::zero())
+    {
+        auto timeout_sqe = local_engine().get_sqe();
+
+        auto ns      = timeout.count();
+        m_ts.tv_sec  = ns / 1000000000;
+        m_ts.tv_nsec = ns % 1000000000;
+        sqe->flags |= IOSQE_IO_LINK;
+        io_uring_prep_link_timeout(timeout_sqe, &m_ts, 0);
+        io_uring_sqe_set_data(timeout_sqe, &m_timeout_info);
+        local_engine().add_io_submit();
+        m_remain++;
+
+        // io without its timeout would run unbounded, so they enter uring together
+        coro::uring::ursptr chain[] = {sqe, timeout_sqe};
+        local_engine().seal_chain(chain);
+    }
+
+    if (token != nullptr)
+    {
+        m_token          = token;
+        token->m_running = this;
+    }
+}
+
+auto io_guard::cancel() noexcept -> void
+{
+    auto sqe = local_engine().get_sqe();
+
+    io_uring_prep_cancel(sqe, &m_io_info, 0);
+    io_uring_sqe_set_data(sqe, &m_cancel_info);
+    local_engine().add_io_submit();
+    m_remain++;
+}
+
+auto io_guard::callback(io_info* data, int res) noexcept -> void
+{
+    auto guard = reinterpret_cast<io_guard*>(data->data);
+    if (data == &guard->m_io_info)
+    {
+        // io forced to nop keeps -ECANCELED
+        if (guard->m_res != -ECANCELED)
+        {
+            guard->m_res = res;
+        }
+        if (guard->m_token != nullptr && guard->m_token->m_running == guard)
+        {
+            guard->m_token->m_running = nullptr;
+        }
+    }
+    else if (data == &guard->m_timeout_info)
+    {
+        guard->m_timed_out = (res == -ETIME);
+    }
+
+    if (--guard->m_remain == 0)
+    {
+        auto res = guard->m_timed_out && guard->m_res == -ECANCELED ? -ETIME : guard->m_res;
+        guard->m_finish(guard, res);
+    }
+}
+
+}; // namespace coro::net::detail
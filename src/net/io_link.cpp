@@ -0,0 +1,28 @@
+#include "coro/net/io_link.hpp"
+#include "coro/scheduler.hpp"
+
+namespace coro::net
+{
+using ::coro::detail::local_engine;
+using detail::io_type;
+
+link_timeout_awaiter::link_timeout_awaiter(std::chrono::nanoseconds timeout) noexcept
+{
+    m_info.type = io_type::none;
+    m_info.cb   = &link_timeout_awaiter::callback;
+
+    auto ns      = timeout.count();
+    m_ts.tv_sec  = ns / 1000000000;
+    m_ts.tv_nsec = ns % 1000000000;
+    io_uring_prep_link_timeout(m_urs, &m_ts, 0);
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+auto link_timeout_awaiter::callback(io_info* data, int res) noexcept -> void
+{
+    data->result = res;
+    submit_to_context(data->handle);
+}
+
+}; // namespace coro::net
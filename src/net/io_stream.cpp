@@ -0,0 +1,113 @@
+#include <cerrno>
+
+#include "coro/net/io_stream.hpp"
+#include "coro/scheduler.hpp"
+
+namespace coro::net
+{
+using ::coro::detail::local_engine;
+
+recv_buffer::recv_buffer(coro::uring::uring_proxy* upxy, detail::stream_entry entry) noexcept : m_res(entry.res)
+{
+    if (entry.flags & IORING_CQE_F_BUFFER)
+    {
+        m_upxy = upxy;
+        m_bid  = static_cast<int32_t>(entry.flags >> IORING_CQE_BUFFER_SHIFT);
+        m_data = upxy->buf_ring_data(static_cast<uint16_t>(m_bid));
+    }
+}
+
+auto recv_buffer::operator=(recv_buffer&& other) noexcept -> recv_buffer&
+{
+    if (this != &other)
+    {
+        release();
+        m_upxy       = other.m_upxy;
+        m_data       = other.m_data;
+        m_res        = other.m_res;
+        m_bid        = other.m_bid;
+        other.m_upxy = nullptr;
+        other.m_data = nullptr;
+        other.m_bid  = -1;
+    }
+    return *this;
+}
+
+auto recv_buffer::release() noexcept -> void
+{
+    if (m_bid >= 0)
+    {
+        m_upxy->recycle_buf_ring(static_cast<uint16_t>(m_bid));
+        m_upxy = nullptr;
+        m_data = nullptr;
+        m_bid  = -1;
+    }
+}
+
+auto tcp_recv_stream::arm() noexcept -> int
+{
+    auto& upxy = local_engine().get_uring();
+    if (!upxy.has_buf_ring())
+    {
+        return -EOPNOTSUPP;
+    }
+
+    auto sqe = local_engine().get_sqe();
+
+    // buffers selected by this io belong to the buffer ring of current engine
+    m_upxy = &upxy;
+    io_uring_prep_recv_multishot(sqe, m_sockfd, nullptr, 0, 0);
+    sqe->flags |= IOSQE_BUFFER_SELECT;
+    sqe->buf_group = coro::uring::uring_proxy::kBufGroupId;
+    submit(sqe);
+    return 0;
+}
+
+udp_datagram::udp_datagram(coro::uring::uring_proxy* upxy, detail::stream_entry entry, msghdr* msg) noexcept
+    : m_buf(upxy, entry)
+{
+    if (m_buf.result() <= 0 || m_buf.data() == nullptr)
+    {
+        return;
+    }
+
+    // buffer starts with io_uring_recvmsg_out, followed by name and payload
+    auto out = io_uring_recvmsg_validate(m_buf.data(), m_buf.result(), msg);
+    if (out == nullptr)
+    {
+        return;
+    }
+    m_from      = static_cast<const sockaddr*>(io_uring_recvmsg_name(out));
+    m_data      = static_cast<char*>(io_uring_recvmsg_payload(out, msg));
+    m_size      = io_uring_recvmsg_payload_length(out, m_buf.result(), msg);
+    m_truncated = (out->flags & MSG_TRUNC) != 0;
+}
+
+auto udp_recv_stream::arm() noexcept -> int
+{
+    auto& upxy = local_engine().get_uring();
+    if (!upxy.has_buf_ring())
+    {
+        return -EOPNOTSUPP;
+    }
+
+    auto sqe = local_engine().get_sqe();
+
+    m_upxy = &upxy;
+    io_uring_prep_recvmsg_multishot(sqe, m_sockfd, &m_msg, 0);
+    sqe->flags |= IOSQE_BUFFER_SELECT;
+    sqe->buf_group = coro::uring::uring_proxy::kBufGroupId;
+    submit(sqe);
+    return 0;
+}
+
+auto tcp_accept_stream::arm() noexcept -> int
+{
+    auto sqe = local_engine().get_sqe();
+
+    io_uring_prep_multishot_accept(sqe, m_listenfd, nullptr, nullptr, m_flags);
+    submit(sqe);
+    return 0;
+}
+
+}; // namespace coro::net
@@ -6,36 +6,39 @@
 
 namespace coro::net
 {
-tcp_server::tcp_server(const char* addr, int port) noexcept
+tcp_server::tcp_server(const char* addr, int port, listen_options opts) noexcept : m_port(port)
 {
-    m_listenfd = socket(AF_INET, SOCK_STREAM, 0);
+    socklen_t addrlen = make_sockaddr(addr, port, &m_servaddr);
+    if (addrlen == 0)
+    {
+        log::info("addr invalid");
+        std::terminate();
+    }
+
+    m_listenfd = socket(m_servaddr.ss_family, SOCK_STREAM, 0);
     assert(m_listenfd != -1);
 
     coro::utils::set_fd_noblock(m_listenfd);
 
-    memset(&m_servaddr, 0, sizeof(m_servaddr));
-    m_servaddr.sin_family = AF_INET;
-    m_servaddr.sin_port   = htons(port);
-    if (addr != nullptr)
+    int on = 1, off = 0;
+    if (opts.reuse_port && setsockopt(m_listenfd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0)
     {
-        if (inet_pton(AF_INET, addr, &m_servaddr.sin_addr.s_addr) < 0)
-        {
-            log::info("addr invalid");
-            std::terminate();
-        }
+        log::info("server set reuse port error");
+        std::terminate();
     }
-    else
+    // ipv6 listener also accepts ipv4 connections as mapped addresses
+    if (m_servaddr.ss_family == AF_INET6)
     {
-        m_servaddr.sin_addr.s_addr = htonl(INADDR_ANY);
+        setsockopt(m_listenfd, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off));
     }
 
-    if (bind(m_listenfd, (sockaddr*)&m_servaddr, sizeof(m_servaddr)) != 0)
+    if (bind(m_listenfd, (sockaddr*)&m_servaddr, addrlen) != 0)
     {
         log::info("server bind error");
         std::terminate();
     }
 
-    if (listen(m_listenfd, ::coro::config::kBacklog) != 0)
+    if (listen(m_listenfd, opts.backlog) != 0)
     {
         log::info("server listen error");
         std::terminate();
@@ -47,32 +50,47 @@ tcp_accept_awaiter tcp_server::accept(int flags) noexcept
     return tcp_accept_awaiter(m_listenfd, flags);
 }
 
-tcp_client::tcp_client(const char* addr, int port) noexcept
+tcp_accept_stream tcp_server::accept_stream(int flags) noexcept
 {
-    m_clientfd = socket(AF_INET, SOCK_STREAM, 0);
+    return tcp_accept_stream(m_listenfd, flags);
+}
+
+tcp_client::tcp_client(const char* addr, int port) noexcept : m_port(port)
+{
+    m_addrlen = make_sockaddr(addr, port, &m_servaddr);
+    assert(m_addrlen != 0 && "addr invalid");
+
+    m_clientfd = socket(m_servaddr.ss_family, SOCK_STREAM, 0);
     assert(m_clientfd != -1);
 
     utils::set_fd_noblock(m_clientfd);
+}
 
-    memset(&m_servaddr, 0, sizeof(m_servaddr));
-    m_servaddr.sin_family = AF_INET;
-    m_servaddr.sin_port   = htons(port);
-    if (addr != nullptr)
+tcp_connect_awaiter tcp_client::connect(int flags) noexcept
+{
+    return tcp_connect_awaiter(m_clientfd, (sockaddr*)&m_servaddr, m_addrlen);
+}
+
+auto make_sockaddr(const char* addr, int port, sockaddr_storage* out) noexcept -> socklen_t
+{
+    memset(out, 0, sizeof(*out));
+    if (addr != nullptr && strchr(addr, ':') != nullptr)
     {
-        if (inet_pton(AF_INET, addr, &m_servaddr.sin_addr.s_addr) < 0)
-        {
-            assert(false);
-        }
+        auto addr6         = reinterpret_cast<sockaddr_in6*>(out);
+        addr6->sin6_family = AF_INET6;
+        addr6->sin6_port   = htons(port);
+        return inet_pton(AF_INET6, addr, &addr6->sin6_addr) == 1 ? sizeof(sockaddr_in6) : 0;
     }
-    else
+
+    auto addr4        = reinterpret_cast<sockaddr_in*>(out);
+    addr4->sin_family = AF_INET;
+    addr4->sin_port   = htons(port);
+    if (addr == nullptr)
     {
-        m_servaddr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr4->sin_addr.s_addr = htonl(INADDR_ANY);
+        return sizeof(sockaddr_in);
     }
-}
-
-tcp_connect_awaiter tcp_client::connect(int flags) noexcept
-{
-    return tcp_connect_awaiter(m_clientfd, (sockaddr*)&m_servaddr, sizeof(m_servaddr));
+    return inet_pton(AF_INET, addr, &addr4->sin_addr) == 1 ? sizeof(sockaddr_in) : 0;
 }
 
 }; // namespace coro::net
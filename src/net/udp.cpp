@@ -0,0 +1,53 @@
+#include <cerrno>
+
+#include "coro/log.hpp"
+#include "coro/net/udp.hpp"
+#include "coro/utils.hpp"
+
+namespace coro::net
+{
+udp_socket::udp_socket() noexcept
+{
+    m_sockfd = socket(AF_INET, SOCK_DGRAM, 0);
+    assert(m_sockfd != -1);
+
+    utils::set_fd_noblock(m_sockfd);
+}
+
+udp_socket::udp_socket(const char* addr, int port) noexcept
+{
+    sockaddr_storage servaddr;
+    socklen_t        addrlen = make_sockaddr(addr, port, &servaddr);
+    if (addrlen == 0)
+    {
+        log::info("udp socket addr invalid");
+        m_sockfd = -1;
+        m_err    = -EINVAL;
+        return;
+    }
+
+    m_sockfd = socket(servaddr.ss_family, SOCK_DGRAM, 0);
+    if (m_sockfd == -1)
+    {
+        m_err = -errno;
+        return;
+    }
+    utils::set_fd_noblock(m_sockfd);
+
+    // ipv6 socket also receives ipv4 datagrams as mapped addresses
+    int off = 0;
+    if (servaddr.ss_family == AF_INET6)
+    {
+        setsockopt(m_sockfd, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off));
+    }
+
+    if (bind(m_sockfd, (sockaddr*)&servaddr, addrlen) != 0)
+    {
+        m_err = -errno;
+        log::info("udp socket bind error");
+        ::close(m_sockfd);
+        m_sockfd = -1;
+    }
+}
+
+}; // namespace coro::net
@@ -0,0 +1,92 @@
+#include <exception>
+#include <sys/stat.h>
+
+#include "coro/log.hpp"
+#include "coro/net/unix.hpp"
+#include "coro/utils.hpp"
+
+namespace coro::net
+{
+static auto make_unix_sockaddr(const char* path) noexcept -> sockaddr_un
+{
+    sockaddr_un sockaddr;
+    memset(&sockaddr, 0, sizeof(sockaddr));
+    sockaddr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(sockaddr.sun_path))
+    {
+        log::info("unix socket path too long");
+        std::terminate();
+    }
+    strcpy(sockaddr.sun_path, path);
+    return sockaddr;
+}
+
+unix_server::unix_server(const char* path, int type) noexcept
+{
+    assert((type == SOCK_STREAM || type == SOCK_SEQPACKET) && "unix server only supports stream and seqpacket");
+
+    m_listenfd = socket(AF_UNIX, type, 0);
+    assert(m_listenfd != -1);
+
+    utils::set_fd_noblock(m_listenfd);
+
+    m_servaddr = make_unix_sockaddr(path);
+    // socket file left by last run makes bind fail, other files are kept and bind fails on them
+    struct stat st;
+    if (lstat(path, &st) == 0 && S_ISSOCK(st.st_mode))
+    {
+        unlink(path);
+    }
+
+    if (bind(m_listenfd, (sockaddr*)&m_servaddr, sizeof(m_servaddr)) != 0)
+    {
+        log::info("unix server bind error");
+        std::terminate();
+    }
+
+    if (listen(m_listenfd, ::coro::config::kBacklog) != 0)
+    {
+        log::info("unix server listen error");
+        std::terminate();
+    }
+}
+
+tcp_accept_awaiter unix_server::accept(int flags) noexcept
+{
+    return tcp_accept_awaiter(m_listenfd, flags);
+}
+
+tcp_accept_stream unix_server::accept_stream(int flags) noexcept
+{
+    return tcp_accept_stream(m_listenfd, flags);
+}
+
+unix_client::unix_client(const char* path, int type) noexcept
+{
+    assert((type == SOCK_STREAM || type == SOCK_SEQPACKET) && "unix client only supports stream and seqpacket");
+
+    m_clientfd = socket(AF_UNIX, type, 0);
+    assert(m_clientfd != -1);
+
+    utils::set_fd_noblock(m_clientfd);
+
+    m_servaddr = make_unix_sockaddr(path);
+}
+
+tcp_connect_awaiter unix_client::connect() noexcept
+{
+    return tcp_connect_awaiter(m_clientfd, (sockaddr*)&m_servaddr, sizeof(m_servaddr));
+}
+
+auto make_socketpair(int type) noexcept -> std::array<int, 2>
+{
+    std::array<int, 2> fds{-1, -1};
+    if (socketpair(AF_UNIX, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds.data()) != 0)
+    {
+        log::info("socketpair error");
+        return {-1, -1};
+    }
+    return fds;
+}
+
+}; // namespace coro::net
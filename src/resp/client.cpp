@@ -0,0 +1,189 @@
+#include <utility>
+
+#include "coro/context.hpp"
+#include "coro/resp/client.hpp"
+
+namespace coro::resp
+{
+static auto make_error(std::string_view reason) -> value
+{
+    value val;
+    val.kind = type::error;
+    val.str.assign(reason);
+    return val;
+}
+
+auto client::connect() -> task<int>
+{
+    int fd = co_await m_client.connect();
+    if (fd < 0)
+    {
+        co_return fd;
+    }
+    m_stream = std::make_unique<net::buffered_stream>(net::tcp_connector(fd));
+    m_broken = false;
+    co_return 0;
+}
+
+auto client::execute(std::span<const std::string_view> args) -> task<value>
+{
+    if (!connected())
+    {
+        co_return make_error("connection closed");
+    }
+
+    pending node;
+    encode_command(m_out, args);
+    push(&node);
+
+    if (!m_writing)
+    {
+        co_await send_out();
+    }
+    if (!node.done)
+    {
+        if (m_reading)
+        {
+            // the reader wakes this command with its reply, or hands the reader role over
+            co_await pending_awaiter{node};
+        }
+        else
+        {
+            m_reading = true;
+        }
+        if (!node.done)
+        {
+            co_await read_replies(node);
+        }
+    }
+    co_return std::move(node.reply);
+}
+
+auto client::close() -> task<int>
+{
+    if (m_stream == nullptr)
+    {
+        co_return 0;
+    }
+    int ret  = co_await m_stream->connector().close();
+    m_stream = nullptr;
+    co_return ret;
+}
+
+auto client::send_out() -> task<>
+{
+    m_writing = true;
+    while (!m_out.empty() && !m_broken)
+    {
+        // commands issued while writing are collected in m_out and sent by the next round
+        m_sending.swap(m_out);
+        size_t sent = 0;
+        while (sent < m_sending.size())
+        {
+            int ret = co_await m_stream->connector().write(m_sending.data() + sent, m_sending.size() - sent);
+            if (ret <= 0)
+            {
+                fail_all("connection closed");
+                break;
+            }
+            sent += ret;
+        }
+        m_sending.clear();
+    }
+    m_writing = false;
+}
+
+auto client::read_replies(pending& self) -> task<>
+{
+    while (!self.done)
+    {
+        auto ret = m_parser.feed(m_stream->buffered());
+        if (ret < 0)
+        {
+            fail_all("protocol error");
+            break;
+        }
+        m_stream->consume(ret);
+
+        if (m_parser.done())
+        {
+            auto reply = m_parser.take();
+            if (reply.kind == type::push)
+            {
+                continue;
+            }
+            if (auto node = pop(); node != nullptr)
+            {
+                finish(node, std::move(reply));
+                continue;
+            }
+            fail_all("unexpected reply");
+            break;
+        }
+
+        auto size = m_stream->buffered().size();
+        if ((co_await m_stream->peek(size + 1)).size() <= size)
+        {
+            fail_all("connection closed");
+            break;
+        }
+    }
+
+    // hand the reader role to the oldest command if it is waiting, otherwise it takes the role itself
+    m_reading = false;
+    if (m_head != nullptr && m_head->handle != nullptr)
+    {
+        m_reading    = true;
+        m_head->lead = true;
+        submit_to_context(std::exchange(m_head->handle, nullptr));
+    }
+}
+
+auto client::push(pending* node) noexcept -> void
+{
+    if (m_tail == nullptr)
+    {
+        m_head = m_tail = node;
+    }
+    else
+    {
+        m_tail->next = node;
+        m_tail       = node;
+    }
+}
+
+auto client::pop() noexcept -> pending*
+{
+    auto node = m_head;
+    if (node != nullptr)
+    {
+        m_head = node->next;
+        if (m_head == nullptr)
+        {
+            m_tail = nullptr;
+        }
+    }
+    return node;
+}
+
+auto client::finish(pending* node, value reply) noexcept -> void
+{
+    node->reply = std::move(reply);
+    node->done  = true;
+    if (node->handle != nullptr)
+    {
+        submit_to_context(std::exchange(node->handle, nullptr));
+    }
+}
+
+auto client::fail_all(std::string_view reason) noexcept -> void
+{
+    m_broken = true;
+    m_parser.reset();
+    while (auto node = pop())
+    {
+        finish(node, make_error(reason));
+    }
+}
+
+}; // namespace coro::resp
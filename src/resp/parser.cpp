@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <charconv>
+#include <utility>
+
+#include "coro/resp/parser.hpp"
+
+namespace coro::resp
+{
+// larger bulk string is refused, the same limit as redis proto-max-bulk-len
+static constexpr int64_t kMaxBulkLen = 512 * 1024 * 1024;
+
+// aggregate with more elements is refused, it also keeps the doubled count of map and attribute in range
+static constexpr int64_t kMaxAggregateLen = kMaxBulkLen;
+
+// reserved slots of aggregate, a huge count claimed by peer doesn't allocate up front
+static constexpr int64_t kMaxReserve = 1024;
+
+static auto parse_int(std::string_view str, int64_t& out) noexcept -> bool
+{
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), out);
+    return ec == std::errc{} && ptr == str.data() + str.size() && !str.empty();
+}
+
+// accept inf, -inf and nan of resp3 as well
+static auto parse_double(std::string_view str, double& out) noexcept -> bool
+{
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), out);
+    return ec == std::errc{} && ptr == str.data() + str.size() && !str.empty();
+}
+
+/**
+ * @brief parse one element at the front of data
+ *
+ * @param count set to the element count if element is an aggregate, otherwise -1
+ * @return int bytes consumed, 0 if incomplete, -1 if malformed
+ */
+static auto parse_element(std::string_view data, value& val, int64_t& count, bool& discard) -> int
+{
+    auto eol = data.find("\r\n");
+    if (eol == std::string_view::npos)
+    {
+        return 0;
+    }
+    if (eol == 0)
+    {
+        return -1;
+    }
+
+    auto    line     = data.substr(1, eol - 1);
+    size_t  consumed = eol + 2;
+    int64_t len      = 0;
+    count            = -1;
+    discard          = false;
+
+    switch (data[0])
+    {
+        case '+':
+        case '-':
+        case '(':
+            val.kind = data[0] == '+' ? type::simple_string : (data[0] == '-' ? type::error : type::big_number);
+            val.str.assign(line);
+            return consumed;
+        case ':':
+            val.kind = type::integer;
+            return parse_int(line, val.integer) ? consumed : -1;
+        case '_':
+            val.kind = type::null;
+            return line.empty() ? consumed : -1;
+        case '#':
+            val.kind    = type::boolean;
+            val.integer = line == "t";
+            return line == "t" || line == "f" ? consumed : -1;
+        case ',':
+            val.kind = type::double_number;
+            return parse_double(line, val.number) ? consumed : -1;
+        case '$':
+        case '!':
+        case '=':
+            if (!parse_int(line, len) || len < -1 || len > kMaxBulkLen)
+            {
+                return -1;
+            }
+            if (len == -1)
+            {
+                val.kind = type::null;
+                return consumed;
+            }
+            if (data.size() < consumed + len + 2)
+            {
+                return 0;
+            }
+            if (data.substr(consumed + len, 2) != "\r\n")
+            {
+                return -1;
+            }
+            val.kind = data[0] == '$' ? type::bulk_string : (data[0] == '!' ? type::bulk_error : type::verbatim_string);
+            val.str.assign(data.substr(consumed, len));
+            return consumed + len + 2;
+        case '*':
+        case '%':
+        case '~':
+        case '>':
+        case '|':
+            if (!parse_int(line, len) || len < -1 || len > kMaxAggregateLen)
+            {
+                return -1;
+            }
+            if (len == -1)
+            {
+                val.kind = type::null;
+                return consumed;
+            }
+            switch (data[0])
+            {
+                case '*':
+                    val.kind = type::array;
+                    break;
+                case '~':
+                    val.kind = type::set;
+                    break;
+                case '>':
+                    val.kind = type::push;
+                    break;
+                default:
+                    val.kind = type::map;
+                    discard  = data[0] == '|';
+                    len *= 2;
+                    break;
+            }
+            val.elements.reserve(std::min(len, kMaxReserve));
+            count = len;
+            return consumed;
+        default:
+            return -1;
+    }
+}
+
+auto parser::feed(std::string_view data) -> int
+{
+    size_t pos = 0;
+    while (!m_done && pos < data.size())
+    {
+        value   val;
+        int64_t count;
+        bool    discard;
+        auto    ret = parse_element(data.substr(pos), val, count, discard);
+        if (ret <= 0)
+        {
+            return ret < 0 ? -1 : static_cast<int>(pos);
+        }
+        pos += ret;
+
+        if (count > 0)
+        {
+            m_stack.push_back(frame{std::move(val), count, discard});
+        }
+        else if (!discard)
+        {
+            complete(std::move(val));
+        }
+    }
+    return static_cast<int>(pos);
+}
+
+auto parser::take() noexcept -> value
+{
+    m_done = false;
+    return std::exchange(m_result, value{});
+}
+
+auto parser::reset() noexcept -> void
+{
+    m_stack.clear();
+    m_result = value{};
+    m_done   = false;
+}
+
+auto parser::complete(value val) -> void
+{
+    while (!m_stack.empty())
+    {
+        auto& top = m_stack.back();
+        top.val.elements.push_back(std::move(val));
+        if (--top.remain > 0)
+        {
+            return;
+        }
+
+        bool discard = top.discard;
+        val          = std::move(top.val);
+        m_stack.pop_back();
+        if (discard)
+        {
+            // attribute only annotates the next element
+            return;
+        }
+    }
+    m_result = std::move(val);
+    m_done   = true;
+}
+
+auto encode_command(std::string& out, std::span<const std::string_view> args) -> void
+{
+    char num[24];
+    auto append_len = [&](char prefix, size_t len)
+    {
+        out.push_back(prefix);
+        out.append(num, std::to_chars(num, num + sizeof(num), len).ptr - num);
+        out.append("\r\n");
+    };
+
+    append_len('*', args.size());
+    for (auto arg : args)
+    {
+        append_len('$', arg.size());
+        out.append(arg);
+        out.append("\r\n");
+    }
+}
+
+}; // namespace coro::resp
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "coro/scheduler.hpp"
 
 namespace coro
@@ -38,4 +40,24 @@ auto scheduler::submit_task_impl(std::coroutine_handle<> handle) noexcept -> voi
     size_t ctx_id = m_dispatcher.dispatch();
     m_ctxs[ctx_id]->submit_task(handle);
 }
+
+auto scheduler::submit_batch_impl(std::span<std::coroutine_handle<>> handles) noexcept -> void
+{
+    if (handles.empty())
+    {
+        return;
+    }
+
+    // every chunk is placed by dispatcher, so load aware strategies see the chunks placed before
+    size_t chunk_cnt = std::min(m_ctx_cnt, handles.size());
+    size_t per_chunk = handles.size() / chunk_cnt;
+    size_t remain    = handles.size() % chunk_cnt;
+    size_t offset    = 0;
+    for (size_t i = 0; i < chunk_cnt; i++)
+    {
+        size_t len = per_chunk + (i < remain ? 1 : 0);
+        m_ctxs[m_dispatcher.dispatch()]->submit_batch(handles.subspan(offset, len));
+        offset += len;
+    }
+}
 }; // namespace coro
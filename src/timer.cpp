@@ -0,0 +1,36 @@
+#include "coro/timer.hpp"
+#include "coro/scheduler.hpp"
+
+namespace coro::detail
+{
+auto sleep_awaiter::await_suspend(std::coroutine_handle<> handle) noexcept -> void
+{
+    if constexpr (config::kEnableTimerWheel)
+    {
+        m_node.handle = handle;
+        local_engine().add_timer(&m_node, m_deadline);
+    }
+    else
+    {
+        auto sqe = local_engine().get_sqe();
+
+        m_info.handle = handle;
+        m_info.type   = net::detail::io_type::none;
+        m_info.cb     = &sleep_awaiter::callback;
+
+        // steady_clock and io_uring absolute timeout both use CLOCK_MONOTONIC
+        auto ns      = std::chrono::duration_cast<std::chrono::nanoseconds>(m_deadline.time_since_epoch()).count();
+        m_ts.tv_sec  = ns / 1000000000;
+        m_ts.tv_nsec = ns % 1000000000;
+        io_uring_prep_timeout(sqe, &m_ts, 0, IORING_TIMEOUT_ABS);
+        io_uring_sqe_set_data(sqe, &m_info);
+        local_engine().add_io_submit();
+    }
+}
+
+auto sleep_awaiter::callback(net::detail::io_info* data, [[CORO_MAYBE_UNUSED]] int res) noexcept -> void
+{
+    submit_to_context(data->handle);
+}
+
+}; // namespace coro::detail
@@ -0,0 +1,296 @@
+#include <array>
+#include <cerrno>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+#include "coro/coro.hpp"
+#include "gtest/gtest.h"
+
+using namespace coro;
+
+/*************************************************************
+ *                       pre-definition                      *
+ *************************************************************/
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+class BufferedStreamTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_fds = net::make_socketpair();
+        ASSERT_GE(m_fds[0], 0);
+        ASSERT_GE(m_fds[1], 0);
+    }
+
+    void TearDown() override
+    {
+        for (auto fd : m_fds)
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+        }
+    }
+
+    // close one end so the other end reads eof, fd is marked closed for TearDown
+    auto shutdown(int idx) -> void
+    {
+        ::close(m_fds[idx]);
+        m_fds[idx] = -1;
+    }
+
+    std::array<int, 2> m_fds{-1, -1};
+};
+
+// read everything from fd until peer closes
+task<> read_all(int fd, std::string& out)
+{
+    auto conn = net::tcp_connector(fd);
+    char buf[4096];
+    while (true)
+    {
+        auto ret = co_await conn.read(buf, sizeof(buf));
+        if (ret <= 0)
+        {
+            break;
+        }
+        out.append(buf, ret);
+    }
+    ::close(fd);
+}
+
+task<> read_lines(int fd, std::vector<std::string>& lines, int& result)
+{
+    // 4 bytes of buffer make the first read stop in the middle of "\r\n"
+    auto stream = net::buffered_stream(net::tcp_connector(fd), 4);
+    while (true)
+    {
+        auto line = co_await stream.read_until("\r\n");
+        if (line.empty())
+        {
+            break;
+        }
+        lines.emplace_back(line);
+    }
+    result = stream.result();
+    lines.emplace_back(stream.buffered());
+}
+
+task<> read_parts(int fd, std::vector<std::string>& parts)
+{
+    auto stream = net::buffered_stream(net::tcp_connector(fd), 8);
+    // fills the whole buffer
+    parts.emplace_back(co_await stream.peek(8));
+    // already buffered, needs neither moving nor growing
+    parts.emplace_back(co_await stream.read_exact(3));
+    // unread bytes sit behind head, the request fits after moving them to the front
+    parts.emplace_back(co_await stream.read_exact(7));
+    // larger than the buffer, so it grows
+    parts.emplace_back(co_await stream.read_exact(30));
+    parts.emplace_back(co_await stream.peek(100));
+}
+
+task<> write_raw(int fd, size_t len)
+{
+    auto        conn = net::tcp_connector(fd);
+    std::string data(len, 'x');
+    size_t      sent = 0;
+    while (sent < data.size())
+    {
+        auto ret = co_await conn.write(data.data() + sent, data.size() - sent);
+        if (ret <= 0)
+        {
+            break;
+        }
+        sent += ret;
+    }
+}
+
+task<> read_oversized(int fd, int& exact_result, int& until_result, bool& until_empty)
+{
+    auto stream = net::buffered_stream(net::tcp_connector(fd));
+    co_await stream.read_exact(config::kStreamBufMaxSize + 1);
+    exact_result = stream.result();
+
+    auto line    = co_await stream.read_until("\n");
+    until_empty  = line.empty();
+    until_result = stream.result();
+}
+
+struct write_stats
+{
+    size_t pending_before{0};
+    size_t pending_after{1};
+    bool   sent_early{true};
+    int    ret{-1};
+};
+
+task<> write_small(int fd, int peer, write_stats& stats)
+{
+    auto stream = net::buffered_stream(net::tcp_connector(fd));
+    for (int i = 0; i < 100; i++)
+    {
+        co_await stream.write("0123456789");
+    }
+    stats.pending_before = stream.pending_write();
+
+    // nothing reaches the socket before flush
+    char c;
+    stats.sent_early = ::recv(peer, &c, 1, MSG_DONTWAIT | MSG_PEEK) > 0;
+
+    stats.ret           = co_await stream.flush();
+    stats.pending_after = stream.pending_write();
+    ::shutdown(fd, SHUT_WR);
+}
+
+task<> write_to_threshold(int fd, write_stats& stats)
+{
+    auto        stream = net::buffered_stream(net::tcp_connector(fd));
+    std::string chunk(1024, 'c');
+    for (size_t i = 0; i < config::kStreamFlushThreshold / chunk.size(); i++)
+    {
+        stats.ret = co_await stream.write(chunk);
+    }
+    stats.pending_after = stream.pending_write();
+    ::shutdown(fd, SHUT_WR);
+}
+
+task<> write_large(int fd, const std::string& large, write_stats& stats)
+{
+    auto stream = net::buffered_stream(net::tcp_connector(fd));
+    co_await stream.write("head");
+    stats.pending_before = stream.pending_write();
+    // pending bytes are flushed first, so order on the wire is kept
+    stats.ret           = co_await stream.write(large);
+    stats.pending_after = stream.pending_write();
+    ::shutdown(fd, SHUT_WR);
+}
+
+/*************************************************************
+ *                          tests                            *
+ *************************************************************/
+
+TEST_F(BufferedStreamTest, ReadUntilDelimSplitAcrossReads)
+{
+    std::string data = "abc\r\ndefghij\r\nk";
+    ASSERT_EQ(::write(m_fds[1], data.data(), data.size()), ssize_t(data.size()));
+    shutdown(1);
+
+    std::vector<std::string> lines;
+    int                      result = 1;
+
+    scheduler::init();
+    submit_to_scheduler(read_lines(m_fds[0], lines, result));
+    scheduler::loop();
+
+    ASSERT_EQ(lines.size(), 3);
+    EXPECT_EQ(lines[0], "abc\r\n");
+    EXPECT_EQ(lines[1], "defghij\r\n");
+    EXPECT_EQ(lines[2], "k");
+    EXPECT_EQ(result, 0);
+}
+
+TEST_F(BufferedStreamTest, ReserveCompactsAndGrows)
+{
+    std::string data;
+    for (int i = 0; i < 64; i++)
+    {
+        data.push_back('a' + i % 26);
+    }
+    ASSERT_EQ(::write(m_fds[1], data.data(), data.size()), ssize_t(data.size()));
+    shutdown(1);
+
+    std::vector<std::string> parts;
+
+    scheduler::init();
+    submit_to_scheduler(read_parts(m_fds[0], parts));
+    scheduler::loop();
+
+    ASSERT_EQ(parts.size(), 5);
+    EXPECT_EQ(parts[0], data.substr(0, 8));
+    EXPECT_EQ(parts[1], data.substr(0, 3));
+    EXPECT_EQ(parts[2], data.substr(3, 7));
+    EXPECT_EQ(parts[3], data.substr(10, 30));
+    EXPECT_EQ(parts[4], data.substr(40));
+}
+
+TEST_F(BufferedStreamTest, MessageLargerThanMaxSizeFailsWithENOBUFS)
+{
+    int  exact_result = 1;
+    int  until_result = 1;
+    bool until_empty  = false;
+
+    scheduler::init();
+    // exactly max size bytes without delim, the reader can buffer all of them but no more
+    submit_to_scheduler(write_raw(m_fds[1], config::kStreamBufMaxSize));
+    submit_to_scheduler(read_oversized(m_fds[0], exact_result, until_result, until_empty));
+    scheduler::loop();
+
+    EXPECT_EQ(exact_result, -ENOBUFS);
+    EXPECT_TRUE(until_empty);
+    EXPECT_EQ(until_result, -ENOBUFS);
+}
+
+TEST_F(BufferedStreamTest, SmallWritesAreCoalesced)
+{
+    write_stats stats;
+    std::string received;
+
+    scheduler::init();
+    submit_to_scheduler(write_small(m_fds[0], m_fds[1], stats));
+    submit_to_scheduler(read_all(m_fds[1], received));
+    scheduler::loop();
+    m_fds[1] = -1;
+
+    EXPECT_EQ(stats.pending_before, 1000);
+    EXPECT_FALSE(stats.sent_early);
+    EXPECT_EQ(stats.ret, 0);
+    EXPECT_EQ(stats.pending_after, 0);
+    ASSERT_EQ(received.size(), 1000);
+    EXPECT_EQ(received.substr(990), "0123456789");
+}
+
+TEST_F(BufferedStreamTest, ReachingThresholdFlushes)
+{
+    write_stats stats;
+    std::string received;
+
+    scheduler::init();
+    submit_to_scheduler(write_to_threshold(m_fds[0], stats));
+    submit_to_scheduler(read_all(m_fds[1], received));
+    scheduler::loop();
+    m_fds[1] = -1;
+
+    EXPECT_EQ(stats.ret, 0);
+    EXPECT_EQ(stats.pending_after, 0);
+    EXPECT_EQ(received.size(), config::kStreamFlushThreshold);
+}
+
+TEST_F(BufferedStreamTest, LargeWriteBypassesBuffer)
+{
+    write_stats stats;
+    std::string received;
+    std::string large(config::kStreamFlushThreshold * 4, 'L');
+
+    scheduler::init();
+    submit_to_scheduler(write_large(m_fds[0], large, stats));
+    submit_to_scheduler(read_all(m_fds[1], received));
+    scheduler::loop();
+    m_fds[1] = -1;
+
+    EXPECT_EQ(stats.pending_before, 4);
+    EXPECT_EQ(stats.ret, 0);
+    EXPECT_EQ(stats.pending_after, 0);
+    ASSERT_EQ(received.size(), 4 + large.size());
+    EXPECT_EQ(received.substr(0, 4), "head");
+    EXPECT_EQ(received.substr(4), large);
+}
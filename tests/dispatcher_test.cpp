@@ -0,0 +1,178 @@
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "coro/dispatcher.hpp"
+#include "gtest/gtest.h"
+
+using namespace coro;
+using namespace coro::detail;
+
+/*************************************************************
+ *                       pre-definition                      *
+ *************************************************************/
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+// load of each context indexed by context id, set by test
+static std::vector<size_t> g_loads;
+
+struct fake_load_reader
+{
+    auto operator()(context& ctx) const noexcept -> size_t { return g_loads[ctx.get_ctx_id()]; }
+};
+
+class DispatcherTest : public ::testing::Test
+{
+protected:
+    void SetUp() override {}
+
+    void TearDown() override { linfo.ctx = nullptr; }
+
+    // build ctx_num contexts whose ids equal their index like scheduler does
+    auto make_ctxs(size_t ctx_num) -> void
+    {
+        init_meta_info();
+        m_ctxs.clear();
+        for (size_t i = 0; i < ctx_num; i++)
+        {
+            m_ctxs.emplace_back(std::make_unique<context>());
+        }
+        g_loads.assign(ctx_num, 0);
+    }
+
+    ctx_container m_ctxs;
+};
+
+/*************************************************************
+ *                          tests                            *
+ *************************************************************/
+
+TEST_F(DispatcherTest, LeastLoadedPicksSmallestLoad)
+{
+    make_ctxs(8);
+    g_loads = {9, 7, 5, 3, 8, 6, 4, 10};
+
+    least_loaded_dispatcher<fake_load_reader> dsp;
+    dsp.init(m_ctxs.size(), &m_ctxs);
+    // whatever the start is, the whole ring is scanned
+    for (size_t i = 0; i < m_ctxs.size() * 2; i++)
+    {
+        ASSERT_EQ(dsp.dispatch(), 3);
+    }
+
+    g_loads[6] = 0;
+    ASSERT_EQ(dsp.dispatch(), 6);
+}
+
+TEST_F(DispatcherTest, LeastLoadedBreaksTiesByRotatingStart)
+{
+    make_ctxs(4);
+    g_loads = {2, 1, 1, 1};
+
+    least_loaded_dispatcher<fake_load_reader> dsp;
+    dsp.init(m_ctxs.size(), &m_ctxs);
+
+    // ties go to the first minimum after the rotating start, so all tied contexts are used in turn
+    std::vector<size_t> picks;
+    for (size_t i = 0; i < 8; i++)
+    {
+        picks.push_back(dsp.dispatch());
+    }
+    std::vector<size_t> expect = {1, 1, 2, 3, 1, 1, 2, 3};
+    ASSERT_EQ(picks, expect);
+
+    // idle contexts are picked round robin
+    g_loads.assign(4, 0);
+    for (size_t i = 0; i < 8; i++)
+    {
+        ASSERT_EQ(dsp.dispatch(), (8 + i) % 4);
+    }
+}
+
+TEST_F(DispatcherTest, PowerOfTwoNeverPicksMoreLoadedOfPair)
+{
+    make_ctxs(2);
+    g_loads = {5, 1};
+
+    power_of_two_dispatcher<fake_load_reader> dsp;
+    dsp.init(m_ctxs.size(), &m_ctxs);
+    for (int i = 0; i < 100; i++)
+    {
+        ASSERT_EQ(dsp.dispatch(), 1);
+    }
+
+    // the most loaded context loses every pair it is sampled in
+    make_ctxs(6);
+    g_loads = {1, 1, 1, 100, 1, 1};
+    dsp.init(m_ctxs.size(), &m_ctxs);
+    std::set<size_t> picked;
+    for (int i = 0; i < 1000; i++)
+    {
+        auto idx = dsp.dispatch();
+        ASSERT_LT(idx, m_ctxs.size());
+        ASSERT_NE(idx, 3);
+        picked.insert(idx);
+    }
+    ASSERT_EQ(picked.size(), m_ctxs.size() - 1);
+}
+
+TEST_F(DispatcherTest, PowerOfTwoSingleContext)
+{
+    make_ctxs(1);
+    g_loads = {100};
+
+    power_of_two_dispatcher<fake_load_reader> dsp;
+    dsp.init(m_ctxs.size(), &m_ctxs);
+    ASSERT_EQ(dsp.dispatch(), 0);
+}
+
+TEST_F(DispatcherTest, LocalityKeepsTaskOnSubmittingContext)
+{
+    make_ctxs(4);
+
+    dispatcher<dispatch_strategy::locality> dsp;
+    dsp.init(m_ctxs.size(), &m_ctxs);
+    for (size_t i = 0; i < m_ctxs.size(); i++)
+    {
+        linfo.ctx = m_ctxs[i].get();
+        ASSERT_EQ(dsp.dispatch(), i);
+        ASSERT_EQ(dsp.dispatch(), i);
+    }
+}
+
+TEST_F(DispatcherTest, LocalityFallsBackToRoundRobin)
+{
+    make_ctxs(4);
+
+    dispatcher<dispatch_strategy::locality> dsp;
+    dsp.init(m_ctxs.size(), &m_ctxs);
+
+    // thread without context
+    linfo.ctx = nullptr;
+    for (size_t i = 0; i < 4; i++)
+    {
+        ASSERT_EQ(dsp.dispatch(), i);
+    }
+
+    // context of another scheduler whose id is out of range
+    context other;
+    ASSERT_GE(other.get_ctx_id(), m_ctxs.size());
+    linfo.ctx = &other;
+    for (size_t i = 0; i < 4; i++)
+    {
+        ASSERT_EQ(dsp.dispatch(), (4 + i) % 4);
+    }
+
+    // context of another scheduler whose id is in range, but the slot holds another context
+    ginfo.context_id = 2;
+    context same_id;
+    ASSERT_EQ(same_id.get_ctx_id(), 2);
+    linfo.ctx = &same_id;
+    ASSERT_EQ(dsp.dispatch(), 0);
+    ASSERT_EQ(dsp.dispatch(), 1);
+}
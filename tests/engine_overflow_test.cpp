@@ -0,0 +1,145 @@
+#include <cerrno>
+#include <vector>
+
+#include "coro/engine.hpp"
+#include "coro/net/io_info.hpp"
+#include "gtest/gtest.h"
+
+using namespace coro;
+
+/*************************************************************
+ *                       pre-definition                      *
+ *************************************************************/
+
+using ::coro::net::detail::io_info;
+using ::coro::uring::ursptr;
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+// result and completion order of one io
+struct io_record
+{
+    int res{1};
+    int order{-1};
+};
+
+static int g_order = 0;
+
+void record_cb(io_info* info, int res)
+{
+    auto rec   = reinterpret_cast<io_record*>(info->data);
+    rec->res   = res;
+    rec->order = g_order++;
+}
+
+// param is the number of free uring slots left when the chain is taken
+class EngineOverflowTest : public ::testing::TestWithParam<int>
+{
+protected:
+    void SetUp() override
+    {
+        g_order = 0;
+        m_engine.init();
+    }
+
+    void TearDown() override { m_engine.deinit(); }
+
+    auto prep(ursptr sqe, size_t idx) -> void
+    {
+        m_infos[idx].data = reinterpret_cast<uintptr_t>(&m_records[idx]);
+        m_infos[idx].cb   = record_cb;
+        io_uring_sqe_set_data(sqe, &m_infos[idx]);
+    }
+
+    auto add_nop(size_t idx) -> void
+    {
+        auto sqe = m_engine.get_sqe();
+        io_uring_prep_nop(sqe);
+        prep(sqe, idx);
+        m_engine.add_io_submit();
+    }
+
+    detail::engine         m_engine;
+    std::vector<io_info>   m_infos;
+    std::vector<io_record> m_records;
+};
+
+/*************************************************************
+ *                          tests                            *
+ *************************************************************/
+
+TEST_P(EngineOverflowTest, LinkedChainStraddlingFullRingStaysIntact)
+{
+    const int    free_slots = GetParam();
+    const size_t filler     = config::kEntryLength - free_slots;
+    const size_t chain_len  = 3;
+    const size_t total      = filler + chain_len + 1;
+    m_infos.resize(total);
+    m_records.resize(total);
+
+    for (size_t i = 0; i < filler; i++)
+    {
+        add_nop(i);
+    }
+
+    // the head fails, so every linked sqe is cancelled only if the chain is submitted as a whole
+    ursptr chain[chain_len];
+    for (size_t i = 0; i < chain_len; i++)
+    {
+        auto sqe = m_engine.get_sqe();
+        if (i == 0)
+        {
+            io_uring_prep_read(sqe, -1, nullptr, 0, 0);
+        }
+        else
+        {
+            io_uring_prep_nop(sqe);
+        }
+        prep(sqe, filler + i);
+        if (i + 1 < chain_len)
+        {
+            sqe->flags |= IOSQE_IO_LINK;
+        }
+        m_engine.add_io_submit();
+        chain[i] = sqe;
+    }
+    m_engine.seal_chain(chain);
+
+    // io taken after the chain can't bypass it
+    add_nop(total - 1);
+
+    if (free_slots < static_cast<int>(chain_len))
+    {
+        ASSERT_GT(m_engine.num_io_overflow(), 0);
+    }
+
+    do
+    {
+        m_engine.poll_submit();
+    } while (!m_engine.empty_io());
+
+    for (size_t i = 0; i < filler; i++)
+    {
+        ASSERT_EQ(m_records[i].res, 0) << "io " << i;
+        ASSERT_EQ(m_records[i].order, static_cast<int>(i));
+    }
+    ASSERT_EQ(m_records[filler].res, -EBADF);
+    for (size_t i = 1; i < chain_len; i++)
+    {
+        ASSERT_EQ(m_records[filler + i].res, -ECANCELED) << "chain sqe " << i;
+    }
+    // chain runs after the io taken before it, the order of cqe entries inside a failed chain is up to kernel
+    for (size_t i = 0; i < chain_len; i++)
+    {
+        ASSERT_GE(m_records[filler + i].order, static_cast<int>(filler)) << "chain sqe " << i;
+        ASSERT_LT(m_records[filler + i].order, static_cast<int>(filler + chain_len)) << "chain sqe " << i;
+    }
+    ASSERT_EQ(m_records[total - 1].res, 0);
+    ASSERT_EQ(m_records[total - 1].order, static_cast<int>(total - 1));
+}
+
+INSTANTIATE_TEST_SUITE_P(EngineOverflowTests, EngineOverflowTest, ::testing::Values(0, 1, 2, 3));
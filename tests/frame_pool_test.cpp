@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "coro/frame_pool.hpp"
+#include "gtest/gtest.h"
+
+using namespace coro::detail;
+
+/*************************************************************
+ *                       pre-definition                      *
+ *************************************************************/
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+struct mem_event
+{
+    void* raw;
+    bool  is_new;
+};
+
+// global operator new and delete are recorded while g_record is true, so the test can tell
+// when frame_pool takes a block from the system and when it gives the block back
+static constexpr size_t    kMaxEvent = 1 << 18;
+static mem_event           g_events[kMaxEvent];
+static std::atomic<size_t> g_event_num{0};
+static std::atomic<bool>   g_record{false};
+static std::atomic<bool>   g_event_lost{false};
+
+static auto record(void* raw, bool is_new) noexcept -> void
+{
+    if (raw == nullptr || !g_record.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    auto idx = g_event_num.fetch_add(1, std::memory_order_relaxed);
+    if (idx >= kMaxEvent)
+    {
+        g_event_lost.store(true, std::memory_order_relaxed);
+        return;
+    }
+    g_events[idx] = mem_event{raw, is_new};
+}
+
+auto operator new(size_t size) -> void*
+{
+    auto ptr = malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    record(ptr, true);
+    return ptr;
+}
+
+auto operator delete(void* ptr) noexcept -> void
+{
+    record(ptr, false);
+    free(ptr);
+}
+
+auto operator delete(void* ptr, size_t) noexcept -> void
+{
+    ::operator delete(ptr);
+}
+
+// block_header of frame_pool sits right before the memory returned by allocate()
+static constexpr size_t kHeaderSize = sizeof(void*) + 2 * sizeof(uint32_t);
+
+static auto raw_of(void* ptr) -> void*
+{
+    return static_cast<char*>(ptr) - kHeaderSize;
+}
+
+// return how many times the block of ptr is given back to the system after it is taken at
+// the last operator new of it before event mark
+static auto release_times(void* ptr, size_t mark) -> int
+{
+    auto   raw   = raw_of(ptr);
+    auto   num   = std::min(g_event_num.load(), kMaxEvent);
+    size_t begin = num;
+    for (size_t i = 0; i < mark; i++)
+    {
+        if (g_events[i].raw == raw && g_events[i].is_new)
+        {
+            begin = i;
+        }
+    }
+    if (begin == num)
+    {
+        return -1;
+    }
+
+    int times = 0;
+    for (size_t i = begin + 1; i < num && !(g_events[i].raw == raw && g_events[i].is_new); i++)
+    {
+        times += g_events[i].raw == raw ? 1 : 0;
+    }
+    return times;
+}
+
+// sizes of several size classes, the last one is too large for pool
+static const std::vector<size_t> kSizes = {1, 40, 100, 300, 1000, 4000, 5000};
+
+class FramePoolTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        g_event_num = 0;
+        g_record    = true;
+    }
+
+    void TearDown() override { g_record = false; }
+
+    // run f in a new thread and wait it to exit, so the pool of that thread is orphaned
+    template<typename func_type>
+    static auto run_thread(func_type f) -> void
+    {
+        std::thread t(f);
+        t.join();
+    }
+};
+
+/*************************************************************
+ *                          tests                            *
+ *************************************************************/
+
+TEST_F(FramePoolTest, RemoteFreeAndOrphanedPool)
+{
+    const int          rounds = 20;
+    std::vector<void*> early, late;
+
+    // owner allocates, half of the blocks are freed by another thread while owner is alive
+    run_thread(
+        [&]()
+        {
+            std::vector<void*> blocks;
+            for (int i = 0; i < rounds; i++)
+            {
+                for (auto size : kSizes)
+                {
+                    blocks.push_back(frame_pool::allocate(size));
+                }
+            }
+            for (size_t i = 0; i < blocks.size(); i++)
+            {
+                (i % 2 == 0 ? early : late).push_back(blocks[i]);
+            }
+            run_thread(
+                [&]()
+                {
+                    for (auto ptr : early)
+                    {
+                        frame_pool::deallocate(ptr);
+                    }
+                });
+        });
+    auto mark = g_event_num.load();
+
+    // exiting owner drains its remote list and releases its cache
+    for (auto ptr : early)
+    {
+        ASSERT_EQ(release_times(ptr, mark), 1);
+    }
+    for (auto ptr : late)
+    {
+        ASSERT_EQ(release_times(ptr, mark), 0);
+    }
+
+    // blocks freed after owner exits wait in the remote list of the orphaned pool
+    std::set<void*> pooled;
+    run_thread(
+        [&]()
+        {
+            for (auto ptr : late)
+            {
+                frame_pool::deallocate(ptr);
+            }
+        });
+    for (auto ptr : late)
+    {
+        auto times = release_times(ptr, mark);
+        if (times == 0)
+        {
+            pooled.insert(ptr);
+        }
+        else
+        {
+            // only blocks too large for pool go back to the system at once
+            ASSERT_EQ(times, 1);
+        }
+    }
+    ASSERT_EQ(pooled.size(), late.size() * (kSizes.size() - 1) / kSizes.size());
+
+    // the next thread adopts the orphaned pool and gets every pooled block back exactly once
+    std::vector<void*> reused;
+    run_thread(
+        [&]()
+        {
+            std::vector<void*> blocks;
+            for (int i = 0; i < rounds / 2; i++)
+            {
+                for (size_t j = 0; j + 1 < kSizes.size(); j++)
+                {
+                    blocks.push_back(frame_pool::allocate(kSizes[j]));
+                }
+            }
+            reused = blocks;
+            for (auto ptr : blocks)
+            {
+                frame_pool::deallocate(ptr);
+            }
+        });
+    ASSERT_FALSE(g_event_lost.load());
+
+    std::set<void*> reused_set(reused.begin(), reused.end());
+    ASSERT_EQ(reused.size(), reused_set.size());
+    ASSERT_EQ(reused_set, pooled);
+
+    // and releases them once it exits
+    for (auto ptr : early)
+    {
+        ASSERT_EQ(release_times(ptr, mark), 1);
+    }
+    for (auto ptr : late)
+    {
+        ASSERT_EQ(release_times(ptr, mark), 1);
+    }
+}
+
+TEST_F(FramePoolTest, ConcurrentRemoteFreeNeverHandsOutLiveBlock)
+{
+    const int         total = 100000;
+    const int         freer = 4;
+    std::mutex        mtx;
+    std::set<void*>   live;
+    std::deque<void*> que;
+    std::atomic<bool> stop{false};
+    std::atomic<int>  freed{0};
+    std::atomic<bool> dup{false};
+
+    std::vector<std::thread> freers;
+    for (int i = 0; i < freer; i++)
+    {
+        freers.emplace_back(
+            [&]()
+            {
+                while (true)
+                {
+                    // read stop first, so queue is surely drained once it is seen empty after stop
+                    bool  done = stop.load(std::memory_order_acquire);
+                    void* ptr  = nullptr;
+                    {
+                        std::lock_guard lk(mtx);
+                        if (!que.empty())
+                        {
+                            ptr = que.front();
+                            que.pop_front();
+                            // block leaves live set before it is freed, owner may get it right after
+                            live.erase(ptr);
+                        }
+                    }
+                    if (ptr != nullptr)
+                    {
+                        frame_pool::deallocate(ptr);
+                        freed.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    else if (done)
+                    {
+                        break;
+                    }
+                }
+            });
+    }
+
+    // owner exits halfway, the rest of blocks are freed to its orphaned pool and reused by the next owner
+    auto owner = [&](int num)
+    {
+        for (int i = 0; i < num; i++)
+        {
+            auto ptr = frame_pool::allocate(kSizes[i % kSizes.size()]);
+
+            std::lock_guard lk(mtx);
+            if (!live.insert(ptr).second)
+            {
+                dup = true;
+            }
+            que.push_back(ptr);
+        }
+    };
+    run_thread([&]() { owner(total / 2); });
+    run_thread([&]() { owner(total / 2); });
+
+    stop.store(true, std::memory_order_release);
+    for (auto& t : freers)
+    {
+        t.join();
+    }
+
+    ASSERT_FALSE(dup.load());
+    ASSERT_EQ(freed.load(), total);
+    ASSERT_TRUE(live.empty());
+}
@@ -0,0 +1,309 @@
+#include <array>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+#include "coro/coro.hpp"
+#include "gtest/gtest.h"
+
+using namespace coro;
+
+/*************************************************************
+ *                       pre-definition                      *
+ *************************************************************/
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+class HttpServerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_fds = net::make_socketpair();
+        ASSERT_GE(m_fds[0], 0);
+        ASSERT_GE(m_fds[1], 0);
+    }
+
+    void TearDown() override {}
+
+    // serve m_fds[0] by srv, send input from m_fds[1] and return everything server sends before closing
+    auto exchange(http::server& srv, std::string input) -> std::string
+    {
+        std::string output;
+        scheduler::init();
+        submit_to_scheduler(srv.session(m_fds[0]));
+        submit_to_scheduler(client(m_fds[1], std::move(input), output));
+        scheduler::loop();
+        return output;
+    }
+
+    static auto client(int fd, std::string input, std::string& output) -> task<>
+    {
+        auto   conn = net::tcp_connector(fd);
+        size_t sent = 0;
+        while (sent < input.size())
+        {
+            auto ret = co_await conn.write(input.data() + sent, input.size() - sent);
+            if (ret <= 0)
+            {
+                break;
+            }
+            sent += ret;
+        }
+
+        char buf[4096];
+        while (true)
+        {
+            auto ret = co_await conn.read(buf, sizeof(buf));
+            if (ret <= 0)
+            {
+                break;
+            }
+            output.append(buf, ret);
+        }
+        co_await conn.close();
+    }
+
+    std::array<int, 2> m_fds{-1, -1};
+};
+
+static auto count(std::string_view str, std::string_view sub) -> size_t
+{
+    size_t num = 0;
+    for (auto pos = str.find(sub); pos != std::string_view::npos; pos = str.find(sub, pos + sub.size()))
+    {
+        num++;
+    }
+    return num;
+}
+
+/*************************************************************
+ *                          tests                            *
+ *************************************************************/
+
+TEST(HttpParserTest, ParseCompleteRequest)
+{
+    std::string_view data = "POST /submit?x=1 HTTP/1.1\r\nHost: example.com\r\nContent-Length: 5\r\n"
+                            "X-Empty:\r\n\r\nhello";
+    http::request    req;
+
+    auto len = http::parse_request(data, req);
+    ASSERT_EQ(len, static_cast<int>(data.size() - 5));
+    EXPECT_EQ(req.method, "POST");
+    EXPECT_EQ(req.target, "/submit?x=1");
+    EXPECT_EQ(req.minor_version, 1);
+    EXPECT_EQ(req.headers().size(), 3);
+    EXPECT_EQ(req.find("HOST"), "example.com");
+    EXPECT_EQ(req.find("x-empty"), "");
+    EXPECT_EQ(req.find("missing"), "");
+    EXPECT_EQ(req.content_length, 5);
+    EXPECT_FALSE(req.chunked);
+    EXPECT_TRUE(req.keep_alive);
+}
+
+TEST(HttpParserTest, PartialRequestAtEveryOffset)
+{
+    std::string_view data = "GET /index.html HTTP/1.1\r\nHost: a\r\nAccept: */*\r\nContent-Length: 3\r\n\r\nabc";
+    http::request    req;
+
+    auto len = http::parse_request(data, req);
+    ASSERT_EQ(len, static_cast<int>(data.size() - 3));
+    for (size_t i = 0; i < static_cast<size_t>(len); i++)
+    {
+        ASSERT_EQ(http::parse_request(data.substr(0, i), req), 0) << "offset " << i;
+    }
+    // body bytes don't change the header length
+    for (size_t i = len; i <= data.size(); i++)
+    {
+        ASSERT_EQ(http::parse_request(data.substr(0, i), req), len) << "offset " << i;
+    }
+}
+
+TEST(HttpParserTest, BareLineFeedEndsLines)
+{
+    std::string_view data = "GET / HTTP/1.1\nHost: a\n\n";
+    http::request    req;
+
+    ASSERT_EQ(http::parse_request(data, req), static_cast<int>(data.size()));
+    EXPECT_EQ(req.find("host"), "a");
+}
+
+TEST(HttpParserTest, HeaderLimits)
+{
+    std::string data = "GET / HTTP/1.1\r\n";
+    for (size_t i = 0; i < config::kHttpMaxHeaders; i++)
+    {
+        data += "X-Header-" + std::to_string(i) + ": v\r\n";
+    }
+    http::request req;
+
+    ASSERT_GT(http::parse_request(data + "\r\n", req), 0);
+    EXPECT_EQ(req.headers().size(), config::kHttpMaxHeaders);
+
+    // one header more than the buffer holds
+    ASSERT_EQ(http::parse_request(data + "X-One-More: v\r\n\r\n", req), -1);
+}
+
+TEST(HttpParserTest, MalformedRequestLine)
+{
+    http::request req;
+    for (std::string_view data : {
+             "GET / HTTP/2.0\r\n\r\n",
+             "GET / HTTP/1.2\r\n\r\n",
+             "GET / HTTP/1.10\r\n\r\n",
+             "GET / HTTP/1\r\n\r\n",
+             "GET / http/1.1\r\n\r\n",
+             "GET /\r\n\r\n",
+             "GET  HTTP/1.1\r\n\r\n",
+             " / HTTP/1.1\r\n\r\n",
+             "\r\n\r\n",
+         })
+    {
+        EXPECT_EQ(http::parse_request(data, req), -1) << data;
+    }
+}
+
+TEST(HttpParserTest, MalformedHeader)
+{
+    http::request req;
+    for (std::string_view data : {
+             "GET / HTTP/1.1\r\nNoColon\r\n\r\n",
+             "GET / HTTP/1.1\r\n: empty name\r\n\r\n",
+             "GET / HTTP/1.1\r\nHost : a\r\n\r\n",
+         })
+    {
+        EXPECT_EQ(http::parse_request(data, req), -1) << data;
+    }
+}
+
+TEST(HttpParserTest, ContentLength)
+{
+    auto parse = [](std::string_view value, http::request& req)
+    {
+        auto data = "POST / HTTP/1.1\r\nContent-Length:" + std::string(value) + "\r\n\r\n";
+        return http::parse_request(data, req);
+    };
+    http::request req;
+
+    ASSERT_GT(parse(" 42 ", req), 0);
+    EXPECT_EQ(req.content_length, 42);
+    ASSERT_GT(parse("0", req), 0);
+    EXPECT_EQ(req.content_length, 0);
+    ASSERT_GT(parse("18446744073709551615", req), 0);
+    EXPECT_EQ(req.content_length, UINT64_MAX);
+
+    for (auto value : {"", "abc", "-1", "+1", "12x", "1 2", "0x10", "18446744073709551616"})
+    {
+        EXPECT_EQ(parse(value, req), -1) << value;
+    }
+}
+
+TEST(HttpParserTest, ConnectionAndTransferEncoding)
+{
+    http::request req;
+
+    ASSERT_GT(http::parse_request("GET / HTTP/1.0\r\n\r\n", req), 0);
+    EXPECT_EQ(req.minor_version, 0);
+    EXPECT_FALSE(req.keep_alive);
+
+    ASSERT_GT(http::parse_request("GET / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n", req), 0);
+    EXPECT_TRUE(req.keep_alive);
+
+    ASSERT_GT(http::parse_request("GET / HTTP/1.1\r\nConnection: close\r\n\r\n", req), 0);
+    EXPECT_FALSE(req.keep_alive);
+
+    ASSERT_GT(http::parse_request("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n", req), 0);
+    EXPECT_TRUE(req.chunked);
+
+    // body length must not be read differently by a proxy in front, such framing is rejected
+    EXPECT_EQ(http::parse_request("POST / HTTP/1.1\r\nTransfer-Encoding: gzip, chunked\r\n\r\n", req), -1);
+    EXPECT_EQ(http::parse_request("POST / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\n", req), -1);
+    EXPECT_EQ(http::parse_request("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n"
+                                  "Transfer-Encoding: chunked\r\n\r\n",
+                                  req),
+              -1);
+    EXPECT_EQ(http::parse_request("POST / HTTP/1.1\r\nContent-Length: 4\r\nTransfer-Encoding: chunked\r\n\r\n", req),
+              -1);
+    EXPECT_EQ(http::parse_request("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\nContent-Length: 4\r\n\r\n", req),
+              -1);
+    EXPECT_EQ(http::parse_request("POST / HTTP/1.1\r\nContent-Length: 4\r\nContent-Length: 5\r\n\r\n", req), -1);
+
+    // duplicate Content-Length with the same value is one length
+    ASSERT_GT(http::parse_request("POST / HTTP/1.1\r\nContent-Length: 4\r\nContent-Length: 4\r\n\r\n", req), 0);
+    EXPECT_EQ(req.content_length, 4);
+
+    // state of the previous request doesn't leak into the next one
+    ASSERT_GT(http::parse_request("GET / HTTP/1.1\r\n\r\n", req), 0);
+    EXPECT_FALSE(req.chunked);
+    EXPECT_TRUE(req.keep_alive);
+    EXPECT_EQ(req.content_length, 0);
+}
+
+TEST_F(HttpServerTest, PipelinedResponsesInOrder)
+{
+    http::server srv([](const http::request& req, http::response& resp) { resp.body(req.target); });
+
+    auto output = exchange(
+        srv,
+        "GET /first HTTP/1.1\r\n\r\n"
+        "POST /second HTTP/1.1\r\nContent-Length: 4\r\n\r\nbody"
+        "GET /third HTTP/1.1\r\nConnection: close\r\n\r\n");
+
+    EXPECT_EQ(count(output, "HTTP/1.1 200 OK\r\n"), 3);
+    auto first  = output.find("\r\n\r\n/first");
+    auto second = output.find("\r\n\r\n/second");
+    auto third  = output.find("\r\n\r\n/third");
+    ASSERT_NE(first, std::string::npos);
+    ASSERT_NE(second, std::string::npos);
+    ASSERT_NE(third, std::string::npos);
+    EXPECT_LT(first, second);
+    EXPECT_LT(second, third);
+    // only the last response closes the connection
+    EXPECT_EQ(count(output, "Connection: close\r\n"), 1);
+    EXPECT_GT(output.find("Connection: close\r\n"), second);
+}
+
+TEST_F(HttpServerTest, HeadResponseHasNoBody)
+{
+    http::server srv([](const http::request&, http::response& resp) { resp.body("hello"); });
+
+    auto output = exchange(srv, "HEAD / HTTP/1.1\r\nConnection: close\r\n\r\n");
+
+    EXPECT_EQ(output.find("HTTP/1.1 200 OK\r\n"), 0);
+    EXPECT_NE(output.find("Content-Length: 5\r\n"), std::string::npos);
+    EXPECT_EQ(output.substr(output.size() - 4), "\r\n\r\n");
+    EXPECT_EQ(output.find("hello"), std::string::npos);
+}
+
+TEST_F(HttpServerTest, Http10KeepAliveIsConfirmed)
+{
+    http::server srv([](const http::request&, http::response& resp) { resp.body("ok"); });
+
+    auto output = exchange(srv, "GET / HTTP/1.0\r\nConnection: keep-alive\r\n\r\nGET / HTTP/1.0\r\n\r\n");
+
+    EXPECT_EQ(count(output, "HTTP/1.1 200 OK\r\n"), 2);
+    auto keep_alive = output.find("Connection: keep-alive\r\n");
+    auto close      = output.find("Connection: close\r\n");
+    ASSERT_NE(keep_alive, std::string::npos);
+    ASSERT_NE(close, std::string::npos);
+    EXPECT_LT(keep_alive, close);
+}
+
+TEST_F(HttpServerTest, StatusOutOfRangeIsSentAs500)
+{
+    http::server srv(
+        [](const http::request& req, http::response& resp)
+        {
+            resp.status(req.target == "/big" ? 1000 : -1);
+            resp.body("x");
+        });
+
+    auto output = exchange(srv, "GET /big HTTP/1.1\r\n\r\nGET /negative HTTP/1.1\r\nConnection: close\r\n\r\n");
+
+    EXPECT_EQ(count(output, "HTTP/1.1 500 Internal Server Error\r\n"), 2);
+}
@@ -0,0 +1,137 @@
+#include <arpa/inet.h>
+#include <array>
+#include <cerrno>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "coro/coro.hpp"
+#include "gtest/gtest.h"
+
+using namespace coro;
+
+/*************************************************************
+ *                       pre-definition                      *
+ *************************************************************/
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+class IoStreamTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_fds = net::make_socketpair();
+        ASSERT_GE(m_fds[0], 0);
+        ASSERT_GE(m_fds[1], 0);
+    }
+
+    void TearDown() override
+    {
+        for (auto fd : m_fds)
+        {
+            ::close(fd);
+        }
+    }
+
+public:
+    struct cancel_result
+    {
+        std::string first;
+        bool        finished{false};
+        int         after{0}; // result yielded by next() after cancel
+    };
+
+protected:
+    std::array<int, 2> m_fds{-1, -1};
+    cancel_result      m_result;
+};
+
+// fetch one buffer from a running multishot recv, then cancel it while more data may be arriving
+task<> recv_then_cancel(int fd, int peer, IoStreamTest::cancel_result& result)
+{
+    net::tcp_recv_stream stream(fd);
+    ::write(peer, "first", 5);
+
+    auto buf     = co_await stream.next();
+    result.first = std::string(buf.data(), buf.size());
+    buf.release();
+
+    ::write(peer, "second", 6);
+    co_await stream.cancel();
+    result.finished = stream.finished();
+    result.after    = (co_await stream.next()).result();
+}
+
+// stream which never armed its io is finished by cancel at once
+task<> cancel_idle(int fd, IoStreamTest::cancel_result& result)
+{
+    net::tcp_recv_stream stream(fd);
+    co_await stream.cancel();
+    result.finished = stream.finished();
+    result.after    = (co_await stream.next()).result();
+}
+
+// accept one connection, then stop the running multishot accept
+task<> accept_then_cancel(int port, IoStreamTest::cancel_result& result)
+{
+    auto server = net::tcp_server(port);
+    auto stream = server.accept_stream();
+
+    int         client = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::connect(client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+
+    int fd       = co_await stream.next();
+    result.first = fd >= 0 ? "accepted" : "failed";
+    co_await stream.cancel();
+    result.finished = stream.finished();
+    result.after    = co_await stream.next();
+
+    ::close(fd);
+    ::close(client);
+}
+
+/*************************************************************
+ *                          tests                            *
+ *************************************************************/
+
+TEST_F(IoStreamTest, CancelRunningRecvStream)
+{
+    scheduler::init();
+    submit_to_scheduler(recv_then_cancel(m_fds[0], m_fds[1], m_result));
+    scheduler::loop();
+
+    ASSERT_EQ(m_result.first, "first");
+    ASSERT_TRUE(m_result.finished);
+    ASSERT_EQ(m_result.after, -ECANCELED);
+}
+
+TEST_F(IoStreamTest, CancelIdleStream)
+{
+    scheduler::init();
+    submit_to_scheduler(cancel_idle(m_fds[0], m_result));
+    scheduler::loop();
+
+    ASSERT_TRUE(m_result.finished);
+    ASSERT_EQ(m_result.after, -ECANCELED);
+}
+
+TEST_F(IoStreamTest, CancelRunningAcceptStream)
+{
+    scheduler::init();
+    submit_to_scheduler(accept_then_cancel(8391, m_result));
+    scheduler::loop();
+
+    ASSERT_EQ(m_result.first, "accepted");
+    ASSERT_TRUE(m_result.finished);
+    ASSERT_EQ(m_result.after, -ECANCELED);
+}
@@ -0,0 +1,388 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "coro/coro.hpp"
+#include "gtest/gtest.h"
+
+using namespace coro;
+
+/*************************************************************
+ *                       pre-definition                      *
+ *************************************************************/
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+// feed data to parser in pieces of step bytes like a socket delivers it, return all complete values
+static auto parse_all(std::string_view data, size_t step, bool& error) -> std::vector<resp::value>
+{
+    std::vector<resp::value> values;
+    resp::parser             parser;
+    std::string              buf;
+
+    error = false;
+    for (size_t pos = 0; pos < data.size(); pos += step)
+    {
+        buf.append(data.substr(pos, step));
+        while (true)
+        {
+            auto ret = parser.feed(buf);
+            if (ret < 0)
+            {
+                error = true;
+                return values;
+            }
+            buf.erase(0, ret);
+            if (!parser.done())
+            {
+                break;
+            }
+            values.push_back(parser.take());
+        }
+    }
+    return values;
+}
+
+static auto parse_one(std::string_view data) -> resp::value
+{
+    bool error  = false;
+    auto values = parse_all(data, data.size(), error);
+    EXPECT_FALSE(error) << data;
+    EXPECT_EQ(values.size(), 1) << data;
+    return values.empty() ? resp::value{} : std::move(values[0]);
+}
+
+class RespClientTest : public ::testing::Test
+{
+protected:
+    void SetUp() override {}
+
+    void TearDown() override {}
+
+public:
+    static constexpr int kWorkerNum = 32;
+
+    struct test_paras
+    {
+        wait_group               wg;
+        std::vector<resp::value> replies{std::vector<resp::value>(kWorkerNum)};
+        std::vector<int>         finish_order;
+        bool                     connected_after{true};
+    };
+
+protected:
+    test_paras m_para;
+};
+
+// mock server answers ECHO with its argument, replies of all buffered commands go out by one write
+task<> echo_session(int fd)
+{
+    auto         stream = net::buffered_stream(net::tcp_connector(fd));
+    resp::parser parser;
+    while (true)
+    {
+        auto ret = parser.feed(stream.buffered());
+        if (ret < 0)
+        {
+            break;
+        }
+        stream.consume(ret);
+        if (!parser.done())
+        {
+            auto size = stream.buffered().size();
+            if (co_await stream.flush() < 0 || (co_await stream.peek(size + 1)).size() <= size)
+            {
+                break;
+            }
+            continue;
+        }
+
+        auto  cmd  = parser.take();
+        auto& args = cmd.elements;
+        if (args.size() == 2 && args[0].str == "ECHO")
+        {
+            auto reply = "$" + std::to_string(args[1].str.size()) + "\r\n" + args[1].str + "\r\n";
+            co_await stream.write(reply);
+        }
+        else
+        {
+            co_await stream.write("-ERR unknown command\r\n");
+        }
+    }
+    co_await stream.flush();
+    co_await stream.connector().close();
+}
+
+// mock server reads num commands without replying, then drops the connection
+task<> drop_session(int fd, int num)
+{
+    auto         stream = net::buffered_stream(net::tcp_connector(fd));
+    resp::parser parser;
+    while (num > 0)
+    {
+        auto ret = parser.feed(stream.buffered());
+        if (ret < 0)
+        {
+            break;
+        }
+        stream.consume(ret);
+        if (parser.done())
+        {
+            parser.take();
+            num--;
+            continue;
+        }
+        auto size = stream.buffered().size();
+        if ((co_await stream.peek(size + 1)).size() <= size)
+        {
+            break;
+        }
+    }
+    co_await stream.connector().close();
+}
+
+task<> mock_server(int port, bool drop)
+{
+    auto server = net::tcp_server(port);
+    int  fd     = co_await server.accept();
+    if (fd < 0)
+    {
+        co_return;
+    }
+    if (drop)
+    {
+        co_await drop_session(fd, RespClientTest::kWorkerNum);
+    }
+    else
+    {
+        co_await echo_session(fd);
+    }
+}
+
+task<> worker(resp::client& cli, RespClientTest::test_paras& para, int id)
+{
+    auto arg         = "value" + std::to_string(id);
+    para.replies[id] = co_await cli.command("ECHO", arg);
+    para.finish_order.push_back(id);
+    para.wg.done();
+}
+
+task<> run_client(int port, RespClientTest::test_paras& para)
+{
+    resp::client cli("127.0.0.1", port);
+    if (co_await cli.connect() < 0)
+    {
+        co_return;
+    }
+
+    // workers run on this context, their commands share the connection and are pipelined
+    para.wg.add(RespClientTest::kWorkerNum);
+    for (int i = 0; i < RespClientTest::kWorkerNum; i++)
+    {
+        submit_to_context(worker(cli, para, i));
+    }
+    co_await para.wg.wait();
+    para.connected_after = cli.connected();
+    co_await cli.close();
+}
+
+/*************************************************************
+ *                          tests                            *
+ *************************************************************/
+
+TEST(RespParserTest, ScalarTypes)
+{
+    auto val = parse_one("+OK\r\n");
+    EXPECT_EQ(val.kind, resp::type::simple_string);
+    EXPECT_EQ(val.str, "OK");
+
+    val = parse_one("-ERR wrong\r\n");
+    EXPECT_TRUE(val.is_error());
+    EXPECT_EQ(val.str, "ERR wrong");
+
+    val = parse_one(":-42\r\n");
+    EXPECT_EQ(val.kind, resp::type::integer);
+    EXPECT_EQ(val.integer, -42);
+
+    val = parse_one("$5\r\nhe\r\no\r\n");
+    EXPECT_EQ(val.kind, resp::type::bulk_string);
+    EXPECT_EQ(val.str, "he\r\no");
+
+    val = parse_one("#t\r\n");
+    EXPECT_EQ(val.kind, resp::type::boolean);
+    EXPECT_EQ(val.integer, 1);
+
+    val = parse_one(",1.5\r\n");
+    EXPECT_EQ(val.kind, resp::type::double_number);
+    EXPECT_EQ(val.number, 1.5);
+
+    val = parse_one("(12345678901234567890\r\n");
+    EXPECT_EQ(val.kind, resp::type::big_number);
+    EXPECT_EQ(val.str, "12345678901234567890");
+
+    val = parse_one("!3\r\nbad\r\n");
+    EXPECT_EQ(val.kind, resp::type::bulk_error);
+    EXPECT_TRUE(val.is_error());
+
+    val = parse_one("=7\r\ntxt:abc\r\n");
+    EXPECT_EQ(val.kind, resp::type::verbatim_string);
+    EXPECT_EQ(val.str, "txt:abc");
+
+    EXPECT_TRUE(parse_one("_\r\n").is_null());
+}
+
+TEST(RespParserTest, EmptyAndNullValues)
+{
+    auto val = parse_one("*0\r\n");
+    EXPECT_EQ(val.kind, resp::type::array);
+    EXPECT_TRUE(val.elements.empty());
+
+    EXPECT_TRUE(parse_one("*-1\r\n").is_null());
+    EXPECT_TRUE(parse_one("$-1\r\n").is_null());
+
+    val = parse_one("$0\r\n\r\n");
+    EXPECT_EQ(val.kind, resp::type::bulk_string);
+    EXPECT_TRUE(val.str.empty());
+
+    val = parse_one("%0\r\n");
+    EXPECT_EQ(val.kind, resp::type::map);
+    EXPECT_TRUE(val.elements.empty());
+}
+
+TEST(RespParserTest, NestedAggregates)
+{
+    // map of an array and a push, with an attribute dropped in front of the map and inside the array
+    std::string_view data = "|1\r\n+ttl\r\n:100\r\n"
+                            "%2\r\n"
+                            "+list\r\n*3\r\n:1\r\n|1\r\n+note\r\n+x\r\n$1\r\n2\r\n*0\r\n"
+                            "+events\r\n>2\r\n+message\r\n~1\r\n#f\r\n";
+
+    auto val = parse_one(data);
+    ASSERT_EQ(val.kind, resp::type::map);
+    ASSERT_EQ(val.elements.size(), 4);
+    EXPECT_EQ(val.elements[0].str, "list");
+
+    auto& list = val.elements[1];
+    ASSERT_EQ(list.kind, resp::type::array);
+    ASSERT_EQ(list.elements.size(), 3);
+    EXPECT_EQ(list.elements[0].integer, 1);
+    EXPECT_EQ(list.elements[1].str, "2");
+    EXPECT_EQ(list.elements[2].kind, resp::type::array);
+
+    EXPECT_EQ(val.elements[2].str, "events");
+    auto& push = val.elements[3];
+    ASSERT_EQ(push.kind, resp::type::push);
+    ASSERT_EQ(push.elements.size(), 2);
+    EXPECT_EQ(push.elements[0].str, "message");
+    ASSERT_EQ(push.elements[1].kind, resp::type::set);
+    ASSERT_EQ(push.elements[1].elements.size(), 1);
+    EXPECT_EQ(push.elements[1].elements[0].integer, 0);
+}
+
+TEST(RespParserTest, ByteByByteFeedMatchesWholeFeed)
+{
+    std::string_view data = "+OK\r\n$0\r\n\r\n*-1\r\n*2\r\n$3\r\nfoo\r\n%1\r\n+k\r\n*1\r\n:7\r\n"
+                            "|1\r\n+a\r\n+b\r\n>1\r\n$4\r\nmsg!\r\n*0\r\n";
+
+    bool error = false;
+    auto whole = parse_all(data, data.size(), error);
+    ASSERT_FALSE(error);
+    ASSERT_EQ(whole.size(), 6);
+
+    for (size_t step = 1; step <= 7; step++)
+    {
+        auto split = parse_all(data, step, error);
+        ASSERT_FALSE(error) << "step " << step;
+        ASSERT_EQ(split.size(), whole.size()) << "step " << step;
+        for (size_t i = 0; i < whole.size(); i++)
+        {
+            EXPECT_EQ(split[i].kind, whole[i].kind) << "step " << step << " value " << i;
+            EXPECT_EQ(split[i].str, whole[i].str) << "step " << step << " value " << i;
+            EXPECT_EQ(split[i].elements.size(), whole[i].elements.size()) << "step " << step << " value " << i;
+        }
+    }
+    EXPECT_EQ(whole[3].elements[0].str, "foo");
+    EXPECT_EQ(whole[3].elements[1].elements[1].elements[0].integer, 7);
+    EXPECT_EQ(whole[4].elements[0].str, "msg!");
+}
+
+TEST(RespParserTest, MalformedInputFails)
+{
+    resp::parser parser;
+    for (std::string_view data : {
+             "\r\n",
+             "x\r\n",
+             ":abc\r\n",
+             ":\r\n",
+             "_x\r\n",
+             "#x\r\n",
+             ",abc\r\n",
+             "$-2\r\n",
+             "$abc\r\n",
+             "$3\r\nabcd\r\n",
+             "*-2\r\n",
+             "*x\r\n",
+             "%4611686018427387904\r\n",
+             "|9223372036854775807\r\n",
+             "*9223372036854775807\r\n",
+             "?1\r\n",
+         })
+    {
+        parser.reset();
+        EXPECT_EQ(parser.feed(data), -1) << data;
+    }
+
+    // the element before the error is consumed, then feeding the error fails
+    parser.reset();
+    EXPECT_EQ(parser.feed("*2\r\n:1\r\n"), 8);
+    EXPECT_EQ(parser.feed("x\r\n"), -1);
+}
+
+TEST(RespParserTest, EncodeCommand)
+{
+    std::string            out;
+    const std::string_view args[] = {"SET", "key", ""};
+    resp::encode_command(out, args);
+    EXPECT_EQ(out, "*3\r\n$3\r\nSET\r\n$3\r\nkey\r\n$0\r\n\r\n");
+
+    auto val = parse_one(out);
+    ASSERT_EQ(val.elements.size(), 3);
+    EXPECT_EQ(val.elements[2].str, "");
+}
+
+TEST_F(RespClientTest, ConcurrentCommandsReturnInOrder)
+{
+    scheduler::init(1);
+    submit_to_scheduler(mock_server(8371, false));
+    submit_to_scheduler(run_client(8371, m_para));
+    scheduler::loop();
+
+    ASSERT_EQ(m_para.finish_order.size(), kWorkerNum);
+    for (int i = 0; i < kWorkerNum; i++)
+    {
+        EXPECT_EQ(m_para.replies[i].kind, resp::type::bulk_string) << i;
+        EXPECT_EQ(m_para.replies[i].str, "value" + std::to_string(i));
+        // replies are handed back in the order commands were issued
+        EXPECT_EQ(m_para.finish_order[i], i);
+    }
+    EXPECT_TRUE(m_para.connected_after);
+}
+
+TEST_F(RespClientTest, PeerDisconnectFailsAllPending)
+{
+    scheduler::init(1);
+    submit_to_scheduler(mock_server(8372, true));
+    submit_to_scheduler(run_client(8372, m_para));
+    scheduler::loop();
+
+    ASSERT_EQ(m_para.finish_order.size(), kWorkerNum);
+    for (int i = 0; i < kWorkerNum; i++)
+    {
+        EXPECT_TRUE(m_para.replies[i].is_error()) << i;
+    }
+    EXPECT_FALSE(m_para.connected_after);
+}
@@ -0,0 +1,284 @@
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include "coro/detail/run_queue.hpp"
+#include "gtest/gtest.h"
+
+using namespace coro;
+using namespace coro::detail;
+
+/*************************************************************
+ *                       pre-definition                      *
+ *************************************************************/
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+// handles are never resumed, they only carry an id
+static auto make_handle(uintptr_t id) -> coroutine_handle<>
+{
+    return coroutine_handle<>::from_address(reinterpret_cast<void*>(id << 4));
+}
+
+static auto handle_id(coroutine_handle<> handle) -> uintptr_t
+{
+    return reinterpret_cast<uintptr_t>(handle.address()) >> 4;
+}
+
+// injection queue of engine, only owner thread touches it in these tests
+struct inject_queue
+{
+    auto try_pop(coroutine_handle<>& handle) -> bool
+    {
+        if (que.empty())
+        {
+            return false;
+        }
+        handle = que.front();
+        que.pop_front();
+        return true;
+    }
+
+    std::deque<coroutine_handle<>> que;
+};
+
+// engine::submit_task() of owner thread, a task run queue doesn't keep goes to injection queue
+template<typename queue_type>
+static auto submit(queue_type& que, inject_queue& inject, coroutine_handle<> handle) -> void
+{
+    if (!que.push(handle))
+    {
+        inject.que.push_back(handle);
+    }
+}
+
+// engine::schedule(), injection queue is drained once run queue has nothing to run
+template<typename queue_type>
+static auto next(queue_type& que, inject_queue& inject, coroutine_handle<>& handle) -> bool
+{
+    return que.pop(handle, inject) || inject.try_pop(handle);
+}
+
+struct starve_result
+{
+    int old_pos{-1};
+    int remote_pos{-1};
+};
+
+static constexpr uintptr_t kPing = 1, kPong = 2, kOldTask = 3, kRemoteTask = 4;
+
+// ping and pong wake each other up on every run, record the pop at which old task and remote task run
+template<typename queue_type>
+static auto run_ping_pong(queue_type& que, inject_queue& inject) -> starve_result
+{
+    starve_result      result;
+    coroutine_handle<> handle;
+    for (int pops = 0; pops < 10 * static_cast<int>(config::kInjectCheckInterval); pops++)
+    {
+        if (!next(que, inject, handle))
+        {
+            break;
+        }
+        auto id = handle_id(handle);
+        if (id == kPing || id == kPong)
+        {
+            submit(que, inject, make_handle(id == kPing ? kPong : kPing));
+        }
+        else if (id == kOldTask)
+        {
+            result.old_pos = pops;
+        }
+        else if (id == kRemoteTask)
+        {
+            result.remote_pos = pops;
+        }
+    }
+    return result;
+}
+
+class RunQueueTest : public ::testing::Test
+{
+protected:
+    void SetUp() override {}
+
+    void TearDown() override {}
+
+    // pop until queue is empty, return ids in order
+    auto drain() -> std::vector<uintptr_t>
+    {
+        std::vector<uintptr_t> ids;
+        coroutine_handle<>     handle;
+        while (next(m_que, m_inject, handle))
+        {
+            ids.push_back(handle_id(handle));
+        }
+        return ids;
+    }
+
+    run_queue<false, true, 1024> m_que;
+    inject_queue                 m_inject;
+};
+
+/*************************************************************
+ *                          tests                            *
+ *************************************************************/
+
+TEST_F(RunQueueTest, OwnerPopsFifo)
+{
+    for (uintptr_t i = 1; i <= 8; i++)
+    {
+        ASSERT_TRUE(m_que.push_back(make_handle(i)));
+    }
+    ASSERT_EQ(m_que.size(), 8);
+
+    auto ids = drain();
+    ASSERT_EQ(ids.size(), 8);
+    for (uintptr_t i = 0; i < 8; i++)
+    {
+        ASSERT_EQ(ids[i], i + 1);
+    }
+    ASSERT_TRUE(m_que.empty());
+}
+
+TEST_F(RunQueueTest, InjectionQueueCheckedPeriodically)
+{
+    // local deque never runs dry, injected tasks still go first once per interval
+    const size_t local_num = config::kInjectCheckInterval * 3;
+    for (uintptr_t i = 1; i <= local_num; i++)
+    {
+        ASSERT_TRUE(m_que.push_back(make_handle(i)));
+    }
+    for (uintptr_t i = 0; i < 3; i++)
+    {
+        m_inject.que.push_back(make_handle(100000 + i));
+    }
+
+    auto ids = drain();
+    ASSERT_EQ(ids.size(), local_num + 3);
+    for (uintptr_t i = 0; i < 3; i++)
+    {
+        ASSERT_EQ(ids[(i + 1) * config::kInjectCheckInterval - 1], 100000 + i);
+    }
+}
+
+TEST_F(RunQueueTest, SelfResubmittingTasksDontStarveOthers)
+{
+    // the old local task and the injected task still run in bounded number of pops
+    ASSERT_TRUE(m_que.push_back(make_handle(kPing)));
+    ASSERT_TRUE(m_que.push_back(make_handle(kOldTask)));
+    m_inject.que.push_back(make_handle(kRemoteTask));
+
+    auto result = run_ping_pong(m_que, m_inject);
+    ASSERT_EQ(result.old_pos, 1);
+    ASSERT_EQ(result.remote_pos, static_cast<int>(config::kInjectCheckInterval) - 1);
+}
+
+TEST_F(RunQueueTest, OwnerAndThievesTakeEveryTaskOnce)
+{
+    const int                     total = 100000;
+    std::vector<std::atomic<int>> seen(total + 1);
+    std::atomic<bool>             stop{false};
+
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < 4; i++)
+    {
+        thieves.emplace_back(
+            [&]()
+            {
+                coroutine_handle<> handle;
+                while (!stop.load(std::memory_order_acquire) || !m_que.empty())
+                {
+                    if (m_que.steal(handle))
+                    {
+                        seen[handle_id(handle)].fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+    }
+
+    // owner pops from the same end as thieves
+    uintptr_t          next = 1;
+    coroutine_handle<> handle;
+    while (next <= static_cast<uintptr_t>(total))
+    {
+        if (m_que.push_back(make_handle(next)))
+        {
+            next++;
+        }
+        if (next % 3 == 0 && m_que.pop(handle, m_inject))
+        {
+            seen[handle_id(handle)].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    while (m_que.pop(handle, m_inject))
+    {
+        seen[handle_id(handle)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    stop.store(true, std::memory_order_release);
+    for (auto& thief : thieves)
+    {
+        thief.join();
+    }
+
+    for (int i = 1; i <= total; i++)
+    {
+        ASSERT_EQ(seen[i].load(), 1) << "task " << i;
+    }
+}
+
+TEST(RunQueueLifoTest, SlotRunsNextUpToStreakLimit)
+{
+    run_queue<true, true, 1024> que;
+    inject_queue                inject;
+
+    auto first = make_handle(1);
+    ASSERT_TRUE(que.push(first));
+    // the newer wakeup takes the slot, the displaced one goes to the back of local deque
+    auto second = make_handle(2);
+    ASSERT_TRUE(que.push(second));
+    ASSERT_EQ(que.size(), 1);
+
+    coroutine_handle<> handle;
+    ASSERT_TRUE(que.pop(handle, inject));
+    ASSERT_EQ(handle_id(handle), 2);
+    ASSERT_TRUE(que.pop(handle, inject));
+    ASSERT_EQ(handle_id(handle), 1);
+    ASSERT_FALSE(que.pop(handle, inject));
+}
+
+TEST(RunQueueLifoTest, StreakLimitWithWorkStealing)
+{
+    run_queue<true, true, 1024> que;
+    inject_queue                inject;
+
+    // ping runs from the slot while old task waits in local deque
+    submit(que, inject, make_handle(kPing));
+    ASSERT_TRUE(que.push_back(make_handle(kOldTask)));
+    inject.que.push_back(make_handle(kRemoteTask));
+
+    auto result = run_ping_pong(que, inject);
+    ASSERT_EQ(result.old_pos, static_cast<int>(config::kLifoStarveLimit));
+    ASSERT_EQ(result.remote_pos, static_cast<int>(config::kInjectCheckInterval) - 1);
+}
+
+TEST(RunQueueLifoTest, StreakLimitWithoutWorkStealing)
+{
+    run_queue<true, false, 1024> que;
+    inject_queue                 inject;
+
+    // without local deque every queued task is in injection queue
+    submit(que, inject, make_handle(kPing));
+    inject.que.push_back(make_handle(kOldTask));
+    inject.que.push_back(make_handle(kRemoteTask));
+
+    auto result = run_ping_pong(que, inject);
+    ASSERT_EQ(result.old_pos, static_cast<int>(config::kLifoStarveLimit));
+    ASSERT_EQ(result.remote_pos, static_cast<int>(config::kLifoStarveLimit) + 1);
+}
@@ -0,0 +1,137 @@
+#include <atomic>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "coro/detail/steal_queue.hpp"
+#include "gtest/gtest.h"
+
+using namespace coro::detail;
+
+/*************************************************************
+ *                       pre-definition                      *
+ *************************************************************/
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+using value_type = uint64_t;
+
+class StealQueueTest : public ::testing::TestWithParam<std::tuple<int, int>>
+{
+protected:
+    void SetUp() override {}
+
+    void TearDown() override {}
+
+    steal_queue<value_type, 1024> m_que;
+};
+
+/*************************************************************
+ *                          tests                            *
+ *************************************************************/
+
+TEST(StealQueueBasicTest, OwnerPopsLifoThiefStealsFifo)
+{
+    steal_queue<value_type, 8> que;
+    for (value_type i = 1; i <= 4; i++)
+    {
+        ASSERT_TRUE(que.push(i));
+    }
+
+    value_type val;
+    ASSERT_TRUE(que.try_pop(val));
+    ASSERT_EQ(val, 4);
+    ASSERT_TRUE(que.try_steal(val));
+    ASSERT_EQ(val, 1);
+    ASSERT_EQ(que.size(), 2);
+}
+
+TEST(StealQueueBasicTest, FullAndEmpty)
+{
+    steal_queue<value_type, 4> que;
+    value_type                 val;
+    ASSERT_FALSE(que.try_pop(val));
+    ASSERT_FALSE(que.try_steal(val));
+
+    for (value_type i = 1; i <= 4; i++)
+    {
+        ASSERT_TRUE(que.push(i));
+    }
+    ASSERT_FALSE(que.push(5));
+
+    for (int i = 0; i < 4; i++)
+    {
+        ASSERT_TRUE(que.try_pop(val));
+    }
+    ASSERT_FALSE(que.try_pop(val));
+    ASSERT_TRUE(que.empty());
+}
+
+TEST_P(StealQueueTest, EveryValueSeenOnce)
+{
+    int thief_num, total;
+    std::tie(thief_num, total) = GetParam();
+
+    std::vector<std::atomic<int>> seen(total + 1);
+    std::atomic<bool>             stop{false};
+
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < thief_num; i++)
+    {
+        thieves.emplace_back(
+            [&]()
+            {
+                value_type val;
+                while (!stop.load(std::memory_order_acquire) || !m_que.empty())
+                {
+                    if (m_que.try_steal(val))
+                    {
+                        seen[val].fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+    }
+
+    // owner interleaves push and pop like a running engine
+    value_type next = 1;
+    value_type val;
+    while (next <= static_cast<value_type>(total))
+    {
+        if (m_que.push(next))
+        {
+            next++;
+        }
+        if (next % 3 == 0 && m_que.try_pop(val))
+        {
+            seen[val].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    while (m_que.try_pop(val))
+    {
+        seen[val].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    stop.store(true, std::memory_order_release);
+    for (auto& thief : thieves)
+    {
+        thief.join();
+    }
+
+    for (int i = 1; i <= total; i++)
+    {
+        ASSERT_EQ(seen[i].load(), 1) << "value " << i;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    StealQueueTests,
+    StealQueueTest,
+    ::testing::Values(
+        std::make_tuple(1, 10000),
+        std::make_tuple(2, 100000),
+        std::make_tuple(4, 100000),
+        std::make_tuple(8, 1000000)));
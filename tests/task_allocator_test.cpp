@@ -0,0 +1,169 @@
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <new>
+
+#include "coro/task.hpp"
+#include "gtest/gtest.h"
+
+using namespace coro;
+
+/*************************************************************
+ *                       pre-definition                      *
+ *************************************************************/
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+struct alloc_stats
+{
+    int                     alloc_num{0};
+    int                     dealloc_num{0};
+    int                     mismatch_num{0}; // deallocate() with a pointer or size this allocator didn't give out
+    std::map<void*, size_t> live;            // pointer -> number of objects
+};
+
+// stateful allocator, copies and rebound copies share the stats of the allocator they come from
+template<typename T>
+struct counting_allocator
+{
+    using value_type = T;
+
+    explicit counting_allocator(alloc_stats* stats) noexcept : stats(stats) {}
+
+    template<typename U>
+    counting_allocator(const counting_allocator<U>& other) noexcept : stats(other.stats)
+    {
+    }
+
+    auto allocate(size_t n) -> T*
+    {
+        auto ptr = static_cast<T*>(::operator new(n * sizeof(T)));
+        stats->alloc_num++;
+        stats->live[ptr] = n;
+        return ptr;
+    }
+
+    auto deallocate(T* ptr, size_t n) noexcept -> void
+    {
+        stats->dealloc_num++;
+        auto it = stats->live.find(ptr);
+        if (it == stats->live.end() || it->second != n)
+        {
+            stats->mismatch_num++;
+            return;
+        }
+        stats->live.erase(it);
+        ::operator delete(ptr);
+    }
+
+    template<typename U>
+    auto operator==(const counting_allocator<U>& other) const noexcept -> bool
+    {
+        return stats == other.stats;
+    }
+
+    alloc_stats* stats;
+};
+
+task<int> add(std::allocator_arg_t, counting_allocator<int> alloc, int lef, int rig)
+{
+    co_return lef + rig;
+}
+
+task<> plain()
+{
+    co_return;
+}
+
+struct adder
+{
+    task<int> add(std::allocator_arg_t, counting_allocator<char> alloc, int val) { co_return base + val; }
+
+    int base;
+};
+
+class TaskAllocatorTest : public ::testing::Test
+{
+protected:
+    void SetUp() override {}
+
+    void TearDown() override {}
+
+    auto expect_balanced(const alloc_stats& stats, int num) -> void
+    {
+        EXPECT_EQ(stats.alloc_num, num);
+        EXPECT_EQ(stats.dealloc_num, num);
+        EXPECT_EQ(stats.mismatch_num, 0);
+        EXPECT_TRUE(stats.live.empty());
+    }
+
+    alloc_stats m_stats;
+};
+
+/*************************************************************
+ *                          tests                            *
+ *************************************************************/
+
+TEST_F(TaskAllocatorTest, FrameComesFromAllocator)
+{
+    {
+        auto t = add(std::allocator_arg, counting_allocator<int>(&m_stats), 1, 2);
+        ASSERT_EQ(m_stats.alloc_num, 1);
+        ASSERT_EQ(m_stats.live.size(), 1);
+        ASSERT_EQ(m_stats.live.begin()->first, t.handle().address());
+
+        t.resume();
+        ASSERT_TRUE(t.is_ready());
+        ASSERT_EQ(t.promise().result(), 3);
+        ASSERT_EQ(m_stats.dealloc_num, 0);
+    }
+    expect_balanced(m_stats, 1);
+}
+
+TEST_F(TaskAllocatorTest, FrameFreedByAllocatorThatAllocatedIt)
+{
+    alloc_stats other;
+    {
+        auto t1 = add(std::allocator_arg, counting_allocator<int>(&m_stats), 1, 2);
+        auto t2 = add(std::allocator_arg, counting_allocator<int>(&other), 3, 4);
+        ASSERT_EQ(m_stats.alloc_num, 1);
+        ASSERT_EQ(other.alloc_num, 1);
+
+        // never resumed frame is freed by the stored allocator too
+        t2.resume();
+        t1.destroy();
+        expect_balanced(m_stats, 1);
+        ASSERT_EQ(other.dealloc_num, 0);
+    }
+    expect_balanced(m_stats, 1);
+    expect_balanced(other, 1);
+}
+
+TEST_F(TaskAllocatorTest, MemberCoroutineUsesAllocator)
+{
+    adder obj{.base = 10};
+    {
+        auto t = obj.add(std::allocator_arg, counting_allocator<char>(&m_stats), 5);
+        ASSERT_EQ(m_stats.alloc_num, 1);
+        t.resume();
+        ASSERT_EQ(t.promise().result(), 15);
+    }
+    expect_balanced(m_stats, 1);
+}
+
+TEST_F(TaskAllocatorTest, DefaultFrameAndAllocatorFrameCoexist)
+{
+    {
+        auto t1 = plain();
+        auto t2 = add(std::allocator_arg, counting_allocator<int>(&m_stats), 1, 1);
+        auto t3 = plain();
+        t1.resume();
+        t2.resume();
+        ASSERT_EQ(t2.promise().result(), 2);
+    }
+    expect_balanced(m_stats, 1);
+}
@@ -0,0 +1,165 @@
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "coro/detail/timer_wheel.hpp"
+#include "gtest/gtest.h"
+
+using namespace coro::detail;
+
+/*************************************************************
+ *                       pre-definition                      *
+ *************************************************************/
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+static constexpr uint64_t kLevel1 = timer_wheel::kSlotNum;
+static constexpr uint64_t kLevel2 = kLevel1 * timer_wheel::kSlotNum;
+static constexpr uint64_t kLevel3 = kLevel2 * timer_wheel::kSlotNum;
+static constexpr uint64_t kBeyond = kLevel3 * timer_wheel::kSlotNum;
+
+class TimerWheelTest : public ::testing::TestWithParam<std::tuple<int, uint64_t>>
+{
+protected:
+    void SetUp() override {}
+
+    void TearDown() override {}
+
+    // advance wheel to now and check every fired timer is due and fires in the first advance reaching it
+    auto advance(uint64_t now) -> void
+    {
+        auto prev = m_wheel.now();
+        m_wheel.advance(
+            now,
+            [&](timer_node* node)
+            {
+                EXPECT_LE(node->expire, now);
+                EXPECT_GT(node->expire, prev);
+                m_fired.push_back(node);
+            });
+        EXPECT_EQ(m_wheel.now(), now);
+    }
+
+    timer_wheel              m_wheel;
+    std::vector<timer_node*> m_fired;
+};
+
+/*************************************************************
+ *                          tests                            *
+ *************************************************************/
+
+TEST(TimerWheelBasicTest, EmptyWheel)
+{
+    timer_wheel wheel;
+    wheel.reset(100);
+    ASSERT_TRUE(wheel.empty());
+    ASSERT_EQ(wheel.next_expire(), timer_wheel::kNever);
+
+    wheel.advance(200, [](timer_node*) { FAIL(); });
+    ASSERT_EQ(wheel.now(), 200);
+}
+
+TEST(TimerWheelBasicTest, ExpiredTimerFiresAtNextTick)
+{
+    timer_wheel wheel;
+    wheel.reset(100);
+
+    timer_node node{.expire = 50};
+    wheel.add(&node);
+    ASSERT_EQ(node.expire, 101);
+    ASSERT_EQ(wheel.next_expire(), 101);
+
+    int fired = 0;
+    wheel.advance(100, [&](timer_node*) { fired++; });
+    ASSERT_EQ(fired, 0);
+    wheel.advance(101, [&](timer_node*) { fired++; });
+    ASSERT_EQ(fired, 1);
+    ASSERT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelBasicTest, SameTickTimersFireTogether)
+{
+    timer_wheel wheel;
+
+    // timers sharing a tick are placed by different current ticks, so they sit in different levels first
+    std::vector<timer_node> nodes(8);
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        nodes[i].expire = kLevel2 + 7;
+        wheel.add(&nodes[i]);
+        wheel.advance(wheel.now() + kLevel1 + 3, [](timer_node*) { FAIL(); });
+    }
+
+    size_t fired = 0;
+    wheel.advance(kLevel2 + 6, [&](timer_node*) { fired++; });
+    ASSERT_EQ(fired, 0);
+    wheel.advance(kLevel2 + 7, [&](timer_node*) { fired++; });
+    ASSERT_EQ(fired, nodes.size());
+    ASSERT_TRUE(wheel.empty());
+}
+
+TEST_F(TimerWheelTest, CascadeThroughEveryLevel)
+{
+    // one timer per level plus one beyond the wheel, each lands off the slot boundary so it must cascade
+    std::vector<timer_node> nodes(5);
+    nodes[0].expire = 5;
+    nodes[1].expire = kLevel1 + 5;
+    nodes[2].expire = kLevel2 + kLevel1 + 5;
+    nodes[3].expire = kLevel3 + kLevel2 + 5;
+    nodes[4].expire = kBeyond + kLevel3 + 5;
+    for (auto& node : nodes)
+    {
+        m_wheel.add(&node);
+    }
+
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        advance(nodes[i].expire - 1);
+        ASSERT_EQ(m_fired.size(), i);
+        ASSERT_LE(m_wheel.next_expire(), nodes[i].expire);
+        advance(nodes[i].expire);
+        ASSERT_EQ(m_fired.size(), i + 1);
+        ASSERT_EQ(m_fired.back(), &nodes[i]);
+    }
+    ASSERT_TRUE(m_wheel.empty());
+}
+
+TEST_P(TimerWheelTest, NeverFiresEarly)
+{
+    int      num  = std::get<0>(GetParam());
+    uint64_t span = std::get<1>(GetParam());
+
+    std::mt19937_64                         rng(num);
+    std::uniform_int_distribution<uint64_t> expire_dist(0, span);
+    std::uniform_int_distribution<uint64_t> step_dist(1, span / 16 + 1);
+
+    m_wheel.reset(12345);
+    std::vector<timer_node> nodes(num);
+    for (auto& node : nodes)
+    {
+        node.expire = m_wheel.now() + expire_dist(rng);
+        m_wheel.add(&node);
+    }
+    ASSERT_EQ(m_wheel.size(), nodes.size());
+
+    while (!m_wheel.empty())
+    {
+        auto next = m_wheel.next_expire();
+        ASSERT_GT(next, m_wheel.now());
+        advance(m_wheel.now() + step_dist(rng));
+    }
+    ASSERT_EQ(m_fired.size(), nodes.size());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    TimerWheelTests,
+    TimerWheelTest,
+    ::testing::Values(
+        std::make_tuple(100, kLevel1),
+        std::make_tuple(1000, kLevel2),
+        std::make_tuple(10000, kLevel3),
+        std::make_tuple(10000, kBeyond * 4)));